@@ -24,18 +24,49 @@
 #define MAIN_DOOR_TX_PIN 24
 #define MAIN_DOOR_RX_PIN 25
 
+// door leaves with their own drive, see DoorChannel.h, one DoorSerialConfig per channel;
+// further drives use DOOR_SERIAL_PIO on free pins, e.g.
+// {DOOR_SERIAL_PIO, <rx pin>, <tx pin>, MAIN_DOOR_SERIAL_BAUD, MAIN_DOOR_SERIAL_CONFIG}
+#define DOOR_CHANNEL_COUNT 1
+#define DOOR_CHANNEL_SERIALS {&MAIN_DOOR_SERIAL, MAIN_DOOR_RX_PIN, MAIN_DOOR_TX_PIN, MAIN_DOOR_SERIAL_BAUD, MAIN_DOOR_SERIAL_CONFIG}
+// drive protocol of all channels, see DoorDrivers.h
+#define DOOR_DRIVER DoorDriverCs80
+
+// contact interface of the drive, see DoorRelay.h; without position feedback,
+// the door state is modelled from the impulses and the drive times below.
+// The pins are not confirmed against a board: on Main v1.2 (hardware/) GPIO
+// 0-8 are wired and J1 is switched from GPIO 14/15/26/27, check them before
+// selecting the contact interface in ETS.
+#define MAIN_MLD_PIN 2
+#define MAIN_MLD_ACTIVE HIGH
+#define MAIN_LCK_PIN 3
+#define MAIN_LCK_ACTIVE HIGH
+#define MAIN_HSK_PIN 5
+#define MAIN_NSK_PIN 6
+#define MAIN_HSK_NSK_ACTIVE HIGH
+#define MAIN_SIGNAL_LENGTH 500
+#define MAIN_RELAY_OPENING_TIME 3000
+#define MAIN_RELAY_CLOSING_TIME 4000
+
 #define MAIN_PWR_PIN 29
 #define MAIN_PWR_THRESHOLD 500
 #define MAIN_PWR_THRESHOLD_MARGIN 50
 
 #define DOOR_OPEN_MIN 3000
+#define DOOR_OPEN_HOLD_MIN 1000
 #define DOOR_STATE_CHANGED_TIMEOUT 3000
+#define DOOR_STATE_CHANGED_TIMEOUT_MIN 500
 
 #define LOCK_PIN 4
 #define LOCK_ACTIVE HIGH
+#define LOCK_REQUEST_MLD_TIMEOUT 10000 // close requested again if the door did not close
+#define LOCK_VERIFY_TIME 1000          // door must stay closed while the bolt engages
+#define LOCK_ATTEMPTS 3
 
 #define SENSOR_TST_PIN 16
 #define SENSOR_TST_ACTIVE HIGH
+#define SENSOR_TST_RESPONSE_MIN 500 // us
+#define SENSOR_TST_RESPONSE_MAX 30000 // us
 #define SENSOR_INSIDE_RAD_PIN 7
 #define SENSOR_INSIDE_AIR_PIN 8
 #define SENSOR_OUTSIDE_RAD_PIN 17
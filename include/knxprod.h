@@ -17,9 +17,9 @@
 #define MAIN_FirmwareName "Tuersteuerung (dev)"
 #define MAIN_OpenKnxId 0xA6
 #define MAIN_ApplicationNumber 0
-#define MAIN_ApplicationVersion 2
+#define MAIN_ApplicationVersion 4
 #define MAIN_ApplicationEncoding iso-8859-15
-#define MAIN_ParameterSize 5893
+#define MAIN_ParameterSize 5895
 #define MAIN_MaxKoNumber 499
 #define MAIN_OrderNumber "OpenKnxDoorControl"
 #define BASE_ModuleVersion 21
@@ -176,17 +176,90 @@
 
 
 
-#define DOR_SafetySensorHsk                     114      // 2 Bits, Bit 7-6
-#define     DOR_SafetySensorHskMask 0xC0
-#define     DOR_SafetySensorHskShift 6
-#define DOR_SafetySensorNsk                     114      // 2 Bits, Bit 5-4
-#define     DOR_SafetySensorNskMask 0x30
-#define     DOR_SafetySensorNskShift 4
+#define DOR_RouteHskOutsideAir                  114      // 1 Bit, Bit 7
+#define     DOR_RouteHskOutsideAirMask 0x80
+#define     DOR_RouteHskOutsideAirShift 7
+#define DOR_RouteHskOutsideRad                  114      // 1 Bit, Bit 6
+#define     DOR_RouteHskOutsideRadMask 0x40
+#define     DOR_RouteHskOutsideRadShift 6
+#define DOR_RouteHskInsideAir                   114      // 1 Bit, Bit 5
+#define     DOR_RouteHskInsideAirMask 0x20
+#define     DOR_RouteHskInsideAirShift 5
+#define DOR_RouteHskInsideRad                   114      // 1 Bit, Bit 4
+#define     DOR_RouteHskInsideRadMask 0x10
+#define     DOR_RouteHskInsideRadShift 4
+#define DOR_PredictiveOpening                   114      // 1 Bit, Bit 3
+#define     DOR_PredictiveOpeningMask 0x08
+#define     DOR_PredictiveOpeningShift 3
+#define DOR_AdaptiveHold                        114      // 1 Bit, Bit 2
+#define     DOR_AdaptiveHoldMask 0x04
+#define     DOR_AdaptiveHoldShift 2
+#define DOR_DriveInterface                      114      // 1 Bit, Bit 1
+#define     DOR_DriveInterfaceMask 0x02
+#define     DOR_DriveInterfaceShift 1
+#define DOR_SensorTest                          114      // 1 Bit, Bit 0
+#define     DOR_SensorTestMask 0x01
+#define     DOR_SensorTestShift 0
+#define DOR_AdaptiveHoldMax                     115      // uint8_t
+#define DOR_RouteNskOutsideAir                  116      // 1 Bit, Bit 7
+#define     DOR_RouteNskOutsideAirMask 0x80
+#define     DOR_RouteNskOutsideAirShift 7
+#define DOR_RouteNskOutsideRad                  116      // 1 Bit, Bit 6
+#define     DOR_RouteNskOutsideRadMask 0x40
+#define     DOR_RouteNskOutsideRadShift 6
+#define DOR_RouteNskInsideAir                   116      // 1 Bit, Bit 5
+#define     DOR_RouteNskInsideAirMask 0x20
+#define     DOR_RouteNskInsideAirShift 5
+#define DOR_RouteNskInsideRad                   116      // 1 Bit, Bit 4
+#define     DOR_RouteNskInsideRadMask 0x10
+#define     DOR_RouteNskInsideRadShift 4
+#define DOR_RouteOpenOutsideAir                 116      // 1 Bit, Bit 3
+#define     DOR_RouteOpenOutsideAirMask 0x08
+#define     DOR_RouteOpenOutsideAirShift 3
+#define DOR_RouteOpenOutsideRad                 116      // 1 Bit, Bit 2
+#define     DOR_RouteOpenOutsideRadMask 0x04
+#define     DOR_RouteOpenOutsideRadShift 2
+#define DOR_RouteOpenInsideAir                  116      // 1 Bit, Bit 1
+#define     DOR_RouteOpenInsideAirMask 0x02
+#define     DOR_RouteOpenInsideAirShift 1
+#define DOR_RouteOpenInsideRad                  116      // 1 Bit, Bit 0
+#define     DOR_RouteOpenInsideRadMask 0x01
+#define     DOR_RouteOpenInsideRadShift 0
 
-// Hauptschließkante (HSK)
-#define ParamDOR_SafetySensorHsk                     ((knx.paramByte(DOR_SafetySensorHsk) & DOR_SafetySensorHskMask) >> DOR_SafetySensorHskShift)
-// Nebenschließkante (NSK)
-#define ParamDOR_SafetySensorNsk                     ((knx.paramByte(DOR_SafetySensorNsk) & DOR_SafetySensorNskMask) >> DOR_SafetySensorNskShift)
+// Vorausschauendes Öffnen
+#define ParamDOR_PredictiveOpening                   ((bool)(knx.paramByte(DOR_PredictiveOpening) & DOR_PredictiveOpeningMask))
+// Adaptive Offenhaltezeit
+#define ParamDOR_AdaptiveHold                        ((bool)(knx.paramByte(DOR_AdaptiveHold) & DOR_AdaptiveHoldMask))
+// Antriebsanschluss
+#define ParamDOR_DriveInterface                      ((knx.paramByte(DOR_DriveInterface) & DOR_DriveInterfaceMask) >> DOR_DriveInterfaceShift)
+// Sensortest vor dem Schließen
+#define ParamDOR_SensorTest                          ((bool)(knx.paramByte(DOR_SensorTest) & DOR_SensorTestMask))
+// Maximale Offenhaltezeit
+#define ParamDOR_AdaptiveHoldMax                     (knx.paramByte(DOR_AdaptiveHoldMax))
+// Präsenz innen
+#define ParamDOR_RouteHskInsideRad                   ((bool)(knx.paramByte(DOR_RouteHskInsideRad) & DOR_RouteHskInsideRadMask))
+// Infrarot innen
+#define ParamDOR_RouteHskInsideAir                   ((bool)(knx.paramByte(DOR_RouteHskInsideAir) & DOR_RouteHskInsideAirMask))
+// Präsenz außen
+#define ParamDOR_RouteHskOutsideRad                  ((bool)(knx.paramByte(DOR_RouteHskOutsideRad) & DOR_RouteHskOutsideRadMask))
+// Infrarot außen
+#define ParamDOR_RouteHskOutsideAir                  ((bool)(knx.paramByte(DOR_RouteHskOutsideAir) & DOR_RouteHskOutsideAirMask))
+// Präsenz innen
+#define ParamDOR_RouteNskInsideRad                   ((bool)(knx.paramByte(DOR_RouteNskInsideRad) & DOR_RouteNskInsideRadMask))
+// Infrarot innen
+#define ParamDOR_RouteNskInsideAir                   ((bool)(knx.paramByte(DOR_RouteNskInsideAir) & DOR_RouteNskInsideAirMask))
+// Präsenz außen
+#define ParamDOR_RouteNskOutsideRad                  ((bool)(knx.paramByte(DOR_RouteNskOutsideRad) & DOR_RouteNskOutsideRadMask))
+// Infrarot außen
+#define ParamDOR_RouteNskOutsideAir                  ((bool)(knx.paramByte(DOR_RouteNskOutsideAir) & DOR_RouteNskOutsideAirMask))
+// Präsenz innen
+#define ParamDOR_RouteOpenInsideRad                  ((bool)(knx.paramByte(DOR_RouteOpenInsideRad) & DOR_RouteOpenInsideRadMask))
+// Infrarot innen
+#define ParamDOR_RouteOpenInsideAir                  ((bool)(knx.paramByte(DOR_RouteOpenInsideAir) & DOR_RouteOpenInsideAirMask))
+// Präsenz außen
+#define ParamDOR_RouteOpenOutsideRad                 ((bool)(knx.paramByte(DOR_RouteOpenOutsideRad) & DOR_RouteOpenOutsideRadMask))
+// Infrarot außen
+#define ParamDOR_RouteOpenOutsideAir                 ((bool)(knx.paramByte(DOR_RouteOpenOutsideAir) & DOR_RouteOpenOutsideAirMask))
 
 #define DOR_KoSwitchInside 101
 #define DOR_KoSwitchOutside 102
@@ -194,6 +267,7 @@
 #define DOR_KoDoorOpenClosed 112
 #define DOR_KoDoorMode 116
 #define DOR_KoDoorModeStatus 117
+#define DOR_KoDoorDirection 118
 #define DOR_KoDoorLock 121
 #define DOR_KoDoorLockStatus 122
 #define DOR_KoPresenceInsideStatus 131
@@ -202,6 +276,11 @@
 #define DOR_KoInfraredOutsideStatus 137
 #define DOR_KoInfraredHskStatus 138
 #define DOR_KoInfraredNskStatus 139
+#define DOR_KoLinkErrors 151
+#define DOR_KoDoorCycles 152
+#define DOR_KoMotorRuntime 153
+#define DOR_KoLockActuations 154
+#define DOR_KoDriveDegraded 155
 
 // Schalter innen
 #define KoDOR_SwitchInside                        (knx.getGroupObject(DOR_KoSwitchInside))
@@ -211,10 +290,12 @@
 #define KoDOR_DoorStatus                          (knx.getGroupObject(DOR_KoDoorStatus))
 // Tür
 #define KoDOR_DoorOpenClosed                      (knx.getGroupObject(DOR_KoDoorOpenClosed))
-// Tür (0=geschlossen, 1=offen, 2=manuell, 3=automatisch)
+// Tür (0=geschlossen, 1=offen, 2=manuell, 3=automatisch, 4=Schleuse, 5=Richtung)
 #define KoDOR_DoorMode                            (knx.getGroupObject(DOR_KoDoorMode))
-// Tür (0=geschlossen, 1=offen, 2=manuell, 3=automatisch)
+// Tür (0=geschlossen, 1=offen, 2=manuell, 3=automatisch, 4=Schleuse, 5=Richtung)
 #define KoDOR_DoorModeStatus                      (knx.getGroupObject(DOR_KoDoorModeStatus))
+// Richtung (0=nur Ausgang, 1=nur Eingang)
+#define KoDOR_DoorDirection                       (knx.getGroupObject(DOR_KoDoorDirection))
 // Schloss
 #define KoDOR_DoorLock                            (knx.getGroupObject(DOR_KoDoorLock))
 // Schloss
@@ -231,255 +312,265 @@
 #define KoDOR_InfraredHskStatus                   (knx.getGroupObject(DOR_KoInfraredHskStatus))
 // Infrarot NSK
 #define KoDOR_InfraredNskStatus                   (knx.getGroupObject(DOR_KoInfraredNskStatus))
+// Antrieb Verbindung
+#define KoDOR_LinkErrors                          (knx.getGroupObject(DOR_KoLinkErrors))
+// Tür
+#define KoDOR_DoorCycles                          (knx.getGroupObject(DOR_KoDoorCycles))
+// Antrieb
+#define KoDOR_MotorRuntime                        (knx.getGroupObject(DOR_KoMotorRuntime))
+// Schloss
+#define KoDOR_LockActuations                      (knx.getGroupObject(DOR_KoLockActuations))
+// Antrieb
+#define KoDOR_DriveDegraded                       (knx.getGroupObject(DOR_KoDriveDegraded))
 
-#define LOG_BuzzerInstalled                     115      // 1 Bit, Bit 7
+#define LOG_BuzzerInstalled                     117      // 1 Bit, Bit 7
 #define     LOG_BuzzerInstalledMask 0x80
 #define     LOG_BuzzerInstalledShift 7
-#define LOG_LedInstalled                        115      // 1 Bit, Bit 6
+#define LOG_LedInstalled                        117      // 1 Bit, Bit 6
 #define     LOG_LedInstalledMask 0x40
 #define     LOG_LedInstalledShift 6
-#define LOG_VacationKo                          115      // 1 Bit, Bit 5
+#define LOG_VacationKo                          117      // 1 Bit, Bit 5
 #define     LOG_VacationKoMask 0x20
 #define     LOG_VacationKoShift 5
-#define LOG_HolidayKo                           115      // 1 Bit, Bit 4
+#define LOG_HolidayKo                           117      // 1 Bit, Bit 4
 #define     LOG_HolidayKoMask 0x10
 #define     LOG_HolidayKoShift 4
-#define LOG_VacationRead                        115      // 1 Bit, Bit 3
+#define LOG_VacationRead                        117      // 1 Bit, Bit 3
 #define     LOG_VacationReadMask 0x08
 #define     LOG_VacationReadShift 3
-#define LOG_HolidaySend                         115      // 1 Bit, Bit 2
+#define LOG_HolidaySend                         117      // 1 Bit, Bit 2
 #define     LOG_HolidaySendMask 0x04
 #define     LOG_HolidaySendShift 2
-#define LOG_Neujahr                             116      // 1 Bit, Bit 7
+#define LOG_Neujahr                             118      // 1 Bit, Bit 7
 #define     LOG_NeujahrMask 0x80
 #define     LOG_NeujahrShift 7
-#define LOG_DreiKoenige                         116      // 1 Bit, Bit 6
+#define LOG_DreiKoenige                         118      // 1 Bit, Bit 6
 #define     LOG_DreiKoenigeMask 0x40
 #define     LOG_DreiKoenigeShift 6
-#define LOG_Weiberfastnacht                     116      // 1 Bit, Bit 5
+#define LOG_Weiberfastnacht                     118      // 1 Bit, Bit 5
 #define     LOG_WeiberfastnachtMask 0x20
 #define     LOG_WeiberfastnachtShift 5
-#define LOG_Rosenmontag                         116      // 1 Bit, Bit 4
+#define LOG_Rosenmontag                         118      // 1 Bit, Bit 4
 #define     LOG_RosenmontagMask 0x10
 #define     LOG_RosenmontagShift 4
-#define LOG_Fastnachtsdienstag                  116      // 1 Bit, Bit 3
+#define LOG_Fastnachtsdienstag                  118      // 1 Bit, Bit 3
 #define     LOG_FastnachtsdienstagMask 0x08
 #define     LOG_FastnachtsdienstagShift 3
-#define LOG_Aschermittwoch                      116      // 1 Bit, Bit 2
+#define LOG_Aschermittwoch                      118      // 1 Bit, Bit 2
 #define     LOG_AschermittwochMask 0x04
 #define     LOG_AschermittwochShift 2
-#define LOG_Frauentag                           116      // 1 Bit, Bit 1
+#define LOG_Frauentag                           118      // 1 Bit, Bit 1
 #define     LOG_FrauentagMask 0x02
 #define     LOG_FrauentagShift 1
-#define LOG_Gruendonnerstag                     116      // 1 Bit, Bit 0
+#define LOG_Gruendonnerstag                     118      // 1 Bit, Bit 0
 #define     LOG_GruendonnerstagMask 0x01
 #define     LOG_GruendonnerstagShift 0
-#define LOG_Karfreitag                          117      // 1 Bit, Bit 7
+#define LOG_Karfreitag                          119      // 1 Bit, Bit 7
 #define     LOG_KarfreitagMask 0x80
 #define     LOG_KarfreitagShift 7
-#define LOG_Ostersonntag                        117      // 1 Bit, Bit 6
+#define LOG_Ostersonntag                        119      // 1 Bit, Bit 6
 #define     LOG_OstersonntagMask 0x40
 #define     LOG_OstersonntagShift 6
-#define LOG_Ostermontag                         117      // 1 Bit, Bit 5
+#define LOG_Ostermontag                         119      // 1 Bit, Bit 5
 #define     LOG_OstermontagMask 0x20
 #define     LOG_OstermontagShift 5
-#define LOG_TagDerArbeit                        117      // 1 Bit, Bit 4
+#define LOG_TagDerArbeit                        119      // 1 Bit, Bit 4
 #define     LOG_TagDerArbeitMask 0x10
 #define     LOG_TagDerArbeitShift 4
-#define LOG_Himmelfahrt                         117      // 1 Bit, Bit 3
+#define LOG_Himmelfahrt                         119      // 1 Bit, Bit 3
 #define     LOG_HimmelfahrtMask 0x08
 #define     LOG_HimmelfahrtShift 3
-#define LOG_Pfingstsonntag                      117      // 1 Bit, Bit 2
+#define LOG_Pfingstsonntag                      119      // 1 Bit, Bit 2
 #define     LOG_PfingstsonntagMask 0x04
 #define     LOG_PfingstsonntagShift 2
-#define LOG_Pfingstmontag                       117      // 1 Bit, Bit 1
+#define LOG_Pfingstmontag                       119      // 1 Bit, Bit 1
 #define     LOG_PfingstmontagMask 0x02
 #define     LOG_PfingstmontagShift 1
-#define LOG_Fronleichnam                        117      // 1 Bit, Bit 0
+#define LOG_Fronleichnam                        119      // 1 Bit, Bit 0
 #define     LOG_FronleichnamMask 0x01
 #define     LOG_FronleichnamShift 0
-#define LOG_Friedensfest                        118      // 1 Bit, Bit 7
+#define LOG_Friedensfest                        120      // 1 Bit, Bit 7
 #define     LOG_FriedensfestMask 0x80
 #define     LOG_FriedensfestShift 7
-#define LOG_MariaHimmelfahrt                    118      // 1 Bit, Bit 6
+#define LOG_MariaHimmelfahrt                    120      // 1 Bit, Bit 6
 #define     LOG_MariaHimmelfahrtMask 0x40
 #define     LOG_MariaHimmelfahrtShift 6
-#define LOG_DeutscheEinheit                     118      // 1 Bit, Bit 5
+#define LOG_DeutscheEinheit                     120      // 1 Bit, Bit 5
 #define     LOG_DeutscheEinheitMask 0x20
 #define     LOG_DeutscheEinheitShift 5
-#define LOG_Reformationstag                     118      // 1 Bit, Bit 4
+#define LOG_Reformationstag                     120      // 1 Bit, Bit 4
 #define     LOG_ReformationstagMask 0x10
 #define     LOG_ReformationstagShift 4
-#define LOG_Allerheiligen                       118      // 1 Bit, Bit 3
+#define LOG_Allerheiligen                       120      // 1 Bit, Bit 3
 #define     LOG_AllerheiligenMask 0x08
 #define     LOG_AllerheiligenShift 3
-#define LOG_BussBettag                          118      // 1 Bit, Bit 2
+#define LOG_BussBettag                          120      // 1 Bit, Bit 2
 #define     LOG_BussBettagMask 0x04
 #define     LOG_BussBettagShift 2
-#define LOG_Advent1                             118      // 1 Bit, Bit 1
+#define LOG_Advent1                             120      // 1 Bit, Bit 1
 #define     LOG_Advent1Mask 0x02
 #define     LOG_Advent1Shift 1
-#define LOG_Advent2                             118      // 1 Bit, Bit 0
+#define LOG_Advent2                             120      // 1 Bit, Bit 0
 #define     LOG_Advent2Mask 0x01
 #define     LOG_Advent2Shift 0
-#define LOG_Advent3                             119      // 1 Bit, Bit 7
+#define LOG_Advent3                             121      // 1 Bit, Bit 7
 #define     LOG_Advent3Mask 0x80
 #define     LOG_Advent3Shift 7
-#define LOG_Advent4                             119      // 1 Bit, Bit 6
+#define LOG_Advent4                             121      // 1 Bit, Bit 6
 #define     LOG_Advent4Mask 0x40
 #define     LOG_Advent4Shift 6
-#define LOG_Heiligabend                         119      // 1 Bit, Bit 5
+#define LOG_Heiligabend                         121      // 1 Bit, Bit 5
 #define     LOG_HeiligabendMask 0x20
 #define     LOG_HeiligabendShift 5
-#define LOG_Weihnachtstag1                      119      // 1 Bit, Bit 4
+#define LOG_Weihnachtstag1                      121      // 1 Bit, Bit 4
 #define     LOG_Weihnachtstag1Mask 0x10
 #define     LOG_Weihnachtstag1Shift 4
-#define LOG_Weihnachtstag2                      119      // 1 Bit, Bit 3
+#define LOG_Weihnachtstag2                      121      // 1 Bit, Bit 3
 #define     LOG_Weihnachtstag2Mask 0x08
 #define     LOG_Weihnachtstag2Shift 3
-#define LOG_Silvester                           119      // 1 Bit, Bit 2
+#define LOG_Silvester                           121      // 1 Bit, Bit 2
 #define     LOG_SilvesterMask 0x04
 #define     LOG_SilvesterShift 2
-#define LOG_Nationalfeiertag                    119      // 1 Bit, Bit 1
+#define LOG_Nationalfeiertag                    121      // 1 Bit, Bit 1
 #define     LOG_NationalfeiertagMask 0x02
 #define     LOG_NationalfeiertagShift 1
-#define LOG_MariaEmpfaengnis                    119      // 1 Bit, Bit 0
+#define LOG_MariaEmpfaengnis                    121      // 1 Bit, Bit 0
 #define     LOG_MariaEmpfaengnisMask 0x01
 #define     LOG_MariaEmpfaengnisShift 0
-#define LOG_NationalfeiertagSchweiz             120      // 1 Bit, Bit 7
+#define LOG_NationalfeiertagSchweiz             122      // 1 Bit, Bit 7
 #define     LOG_NationalfeiertagSchweizMask 0x80
 #define     LOG_NationalfeiertagSchweizShift 7
-#define LOG_Totensonntag                        120      // 1 Bit, Bit 6
+#define LOG_Totensonntag                        122      // 1 Bit, Bit 6
 #define     LOG_TotensonntagMask 0x40
 #define     LOG_TotensonntagShift 6
-#define LOG_Weltkindertag                       120      // 1 Bit, Bit 5
+#define LOG_Weltkindertag                       122      // 1 Bit, Bit 5
 #define     LOG_WeltkindertagMask 0x20
 #define     LOG_WeltkindertagShift 5
-#define LOG_BuzzerSilent                        121      // uint16_t
-#define LOG_BuzzerNormal                        123      // uint16_t
-#define LOG_BuzzerLoud                          125      // uint16_t
-#define LOG_VisibleChannels                     127      // uint8_t
-#define LOG_LedMapping                          128      // 3 Bits, Bit 7-5
+#define LOG_BuzzerSilent                        123      // uint16_t
+#define LOG_BuzzerNormal                        125      // uint16_t
+#define LOG_BuzzerLoud                          127      // uint16_t
+#define LOG_VisibleChannels                     129      // uint8_t
+#define LOG_LedMapping                          130      // 3 Bits, Bit 7-5
 #define     LOG_LedMappingMask 0xE0
 #define     LOG_LedMappingShift 5
-#define LOG_UserFormula1                        129      // char*, 99 Byte
-#define LOG_UserFormula1Active                  228      // 1 Bit, Bit 7
+#define LOG_UserFormula1                        131      // char*, 99 Byte
+#define LOG_UserFormula1Active                  230      // 1 Bit, Bit 7
 #define     LOG_UserFormula1ActiveMask 0x80
 #define     LOG_UserFormula1ActiveShift 7
-#define LOG_UserFormula2                        229      // char*, 99 Byte
-#define LOG_UserFormula2Active                  328      // 1 Bit, Bit 7
+#define LOG_UserFormula2                        231      // char*, 99 Byte
+#define LOG_UserFormula2Active                  330      // 1 Bit, Bit 7
 #define     LOG_UserFormula2ActiveMask 0x80
 #define     LOG_UserFormula2ActiveShift 7
-#define LOG_UserFormula3                        329      // char*, 99 Byte
-#define LOG_UserFormula3Active                  428      // 1 Bit, Bit 7
+#define LOG_UserFormula3                        331      // char*, 99 Byte
+#define LOG_UserFormula3Active                  430      // 1 Bit, Bit 7
 #define     LOG_UserFormula3ActiveMask 0x80
 #define     LOG_UserFormula3ActiveShift 7
-#define LOG_UserFormula4                        429      // char*, 99 Byte
-#define LOG_UserFormula4Active                  528      // 1 Bit, Bit 7
+#define LOG_UserFormula4                        431      // char*, 99 Byte
+#define LOG_UserFormula4Active                  530      // 1 Bit, Bit 7
 #define     LOG_UserFormula4ActiveMask 0x80
 #define     LOG_UserFormula4ActiveShift 7
-#define LOG_UserFormula5                        529      // char*, 99 Byte
-#define LOG_UserFormula5Active                  628      // 1 Bit, Bit 7
+#define LOG_UserFormula5                        531      // char*, 99 Byte
+#define LOG_UserFormula5Active                  630      // 1 Bit, Bit 7
 #define     LOG_UserFormula5ActiveMask 0x80
 #define     LOG_UserFormula5ActiveShift 7
-#define LOG_UserFormula6                        629      // char*, 99 Byte
-#define LOG_UserFormula6Active                  728      // 1 Bit, Bit 7
+#define LOG_UserFormula6                        631      // char*, 99 Byte
+#define LOG_UserFormula6Active                  730      // 1 Bit, Bit 7
 #define     LOG_UserFormula6ActiveMask 0x80
 #define     LOG_UserFormula6ActiveShift 7
-#define LOG_UserFormula7                        729      // char*, 99 Byte
-#define LOG_UserFormula7Active                  828      // 1 Bit, Bit 7
+#define LOG_UserFormula7                        731      // char*, 99 Byte
+#define LOG_UserFormula7Active                  830      // 1 Bit, Bit 7
 #define     LOG_UserFormula7ActiveMask 0x80
 #define     LOG_UserFormula7ActiveShift 7
-#define LOG_UserFormula8                        829      // char*, 99 Byte
-#define LOG_UserFormula8Active                  928      // 1 Bit, Bit 7
+#define LOG_UserFormula8                        831      // char*, 99 Byte
+#define LOG_UserFormula8Active                  930      // 1 Bit, Bit 7
 #define     LOG_UserFormula8ActiveMask 0x80
 #define     LOG_UserFormula8ActiveShift 7
-#define LOG_UserFormula9                        929      // char*, 99 Byte
-#define LOG_UserFormula9Active                  1028      // 1 Bit, Bit 7
+#define LOG_UserFormula9                        931      // char*, 99 Byte
+#define LOG_UserFormula9Active                  1030      // 1 Bit, Bit 7
 #define     LOG_UserFormula9ActiveMask 0x80
 #define     LOG_UserFormula9ActiveShift 7
-#define LOG_UserFormula10                       1029      // char*, 99 Byte
-#define LOG_UserFormula10Active                 1128      // 1 Bit, Bit 7
+#define LOG_UserFormula10                       1031      // char*, 99 Byte
+#define LOG_UserFormula10Active                 1130      // 1 Bit, Bit 7
 #define     LOG_UserFormula10ActiveMask 0x80
 #define     LOG_UserFormula10ActiveShift 7
-#define LOG_UserFormula11                       1129      // char*, 99 Byte
-#define LOG_UserFormula11Active                 1228      // 1 Bit, Bit 7
+#define LOG_UserFormula11                       1131      // char*, 99 Byte
+#define LOG_UserFormula11Active                 1230      // 1 Bit, Bit 7
 #define     LOG_UserFormula11ActiveMask 0x80
 #define     LOG_UserFormula11ActiveShift 7
-#define LOG_UserFormula12                       1229      // char*, 99 Byte
-#define LOG_UserFormula12Active                 1328      // 1 Bit, Bit 7
+#define LOG_UserFormula12                       1231      // char*, 99 Byte
+#define LOG_UserFormula12Active                 1330      // 1 Bit, Bit 7
 #define     LOG_UserFormula12ActiveMask 0x80
 #define     LOG_UserFormula12ActiveShift 7
-#define LOG_UserFormula13                       1329      // char*, 99 Byte
-#define LOG_UserFormula13Active                 1428      // 1 Bit, Bit 7
+#define LOG_UserFormula13                       1331      // char*, 99 Byte
+#define LOG_UserFormula13Active                 1430      // 1 Bit, Bit 7
 #define     LOG_UserFormula13ActiveMask 0x80
 #define     LOG_UserFormula13ActiveShift 7
-#define LOG_UserFormula14                       1429      // char*, 99 Byte
-#define LOG_UserFormula14Active                 1528      // 1 Bit, Bit 7
+#define LOG_UserFormula14                       1431      // char*, 99 Byte
+#define LOG_UserFormula14Active                 1530      // 1 Bit, Bit 7
 #define     LOG_UserFormula14ActiveMask 0x80
 #define     LOG_UserFormula14ActiveShift 7
-#define LOG_UserFormula15                       1529      // char*, 99 Byte
-#define LOG_UserFormula15Active                 1628      // 1 Bit, Bit 7
+#define LOG_UserFormula15                       1531      // char*, 99 Byte
+#define LOG_UserFormula15Active                 1630      // 1 Bit, Bit 7
 #define     LOG_UserFormula15ActiveMask 0x80
 #define     LOG_UserFormula15ActiveShift 7
-#define LOG_UserFormula16                       1629      // char*, 99 Byte
-#define LOG_UserFormula16Active                 1728      // 1 Bit, Bit 7
+#define LOG_UserFormula16                       1631      // char*, 99 Byte
+#define LOG_UserFormula16Active                 1730      // 1 Bit, Bit 7
 #define     LOG_UserFormula16ActiveMask 0x80
 #define     LOG_UserFormula16ActiveShift 7
-#define LOG_UserFormula17                       1729      // char*, 99 Byte
-#define LOG_UserFormula17Active                 1828      // 1 Bit, Bit 7
+#define LOG_UserFormula17                       1731      // char*, 99 Byte
+#define LOG_UserFormula17Active                 1830      // 1 Bit, Bit 7
 #define     LOG_UserFormula17ActiveMask 0x80
 #define     LOG_UserFormula17ActiveShift 7
-#define LOG_UserFormula18                       1829      // char*, 99 Byte
-#define LOG_UserFormula18Active                 1928      // 1 Bit, Bit 7
+#define LOG_UserFormula18                       1831      // char*, 99 Byte
+#define LOG_UserFormula18Active                 1930      // 1 Bit, Bit 7
 #define     LOG_UserFormula18ActiveMask 0x80
 #define     LOG_UserFormula18ActiveShift 7
-#define LOG_UserFormula19                       1929      // char*, 99 Byte
-#define LOG_UserFormula19Active                 2028      // 1 Bit, Bit 7
+#define LOG_UserFormula19                       1931      // char*, 99 Byte
+#define LOG_UserFormula19Active                 2030      // 1 Bit, Bit 7
 #define     LOG_UserFormula19ActiveMask 0x80
 #define     LOG_UserFormula19ActiveShift 7
-#define LOG_UserFormula20                       2029      // char*, 99 Byte
-#define LOG_UserFormula20Active                 2128      // 1 Bit, Bit 7
+#define LOG_UserFormula20                       2031      // char*, 99 Byte
+#define LOG_UserFormula20Active                 2130      // 1 Bit, Bit 7
 #define     LOG_UserFormula20ActiveMask 0x80
 #define     LOG_UserFormula20ActiveShift 7
-#define LOG_UserFormula21                       2129      // char*, 99 Byte
-#define LOG_UserFormula21Active                 2228      // 1 Bit, Bit 7
+#define LOG_UserFormula21                       2131      // char*, 99 Byte
+#define LOG_UserFormula21Active                 2230      // 1 Bit, Bit 7
 #define     LOG_UserFormula21ActiveMask 0x80
 #define     LOG_UserFormula21ActiveShift 7
-#define LOG_UserFormula22                       2229      // char*, 99 Byte
-#define LOG_UserFormula22Active                 2328      // 1 Bit, Bit 7
+#define LOG_UserFormula22                       2231      // char*, 99 Byte
+#define LOG_UserFormula22Active                 2330      // 1 Bit, Bit 7
 #define     LOG_UserFormula22ActiveMask 0x80
 #define     LOG_UserFormula22ActiveShift 7
-#define LOG_UserFormula23                       2329      // char*, 99 Byte
-#define LOG_UserFormula23Active                 2428      // 1 Bit, Bit 7
+#define LOG_UserFormula23                       2331      // char*, 99 Byte
+#define LOG_UserFormula23Active                 2430      // 1 Bit, Bit 7
 #define     LOG_UserFormula23ActiveMask 0x80
 #define     LOG_UserFormula23ActiveShift 7
-#define LOG_UserFormula24                       2429      // char*, 99 Byte
-#define LOG_UserFormula24Active                 2528      // 1 Bit, Bit 7
+#define LOG_UserFormula24                       2431      // char*, 99 Byte
+#define LOG_UserFormula24Active                 2530      // 1 Bit, Bit 7
 #define     LOG_UserFormula24ActiveMask 0x80
 #define     LOG_UserFormula24ActiveShift 7
-#define LOG_UserFormula25                       2529      // char*, 99 Byte
-#define LOG_UserFormula25Active                 2628      // 1 Bit, Bit 7
+#define LOG_UserFormula25                       2531      // char*, 99 Byte
+#define LOG_UserFormula25Active                 2630      // 1 Bit, Bit 7
 #define     LOG_UserFormula25ActiveMask 0x80
 #define     LOG_UserFormula25ActiveShift 7
-#define LOG_UserFormula26                       2629      // char*, 99 Byte
-#define LOG_UserFormula26Active                 2728      // 1 Bit, Bit 7
+#define LOG_UserFormula26                       2631      // char*, 99 Byte
+#define LOG_UserFormula26Active                 2730      // 1 Bit, Bit 7
 #define     LOG_UserFormula26ActiveMask 0x80
 #define     LOG_UserFormula26ActiveShift 7
-#define LOG_UserFormula27                       2729      // char*, 99 Byte
-#define LOG_UserFormula27Active                 2828      // 1 Bit, Bit 7
+#define LOG_UserFormula27                       2731      // char*, 99 Byte
+#define LOG_UserFormula27Active                 2830      // 1 Bit, Bit 7
 #define     LOG_UserFormula27ActiveMask 0x80
 #define     LOG_UserFormula27ActiveShift 7
-#define LOG_UserFormula28                       2829      // char*, 99 Byte
-#define LOG_UserFormula28Active                 2928      // 1 Bit, Bit 7
+#define LOG_UserFormula28                       2831      // char*, 99 Byte
+#define LOG_UserFormula28Active                 2930      // 1 Bit, Bit 7
 #define     LOG_UserFormula28ActiveMask 0x80
 #define     LOG_UserFormula28ActiveShift 7
-#define LOG_UserFormula29                       2929      // char*, 99 Byte
-#define LOG_UserFormula29Active                 3028      // 1 Bit, Bit 7
+#define LOG_UserFormula29                       2931      // char*, 99 Byte
+#define LOG_UserFormula29Active                 3030      // 1 Bit, Bit 7
 #define     LOG_UserFormula29ActiveMask 0x80
 #define     LOG_UserFormula29ActiveShift 7
-#define LOG_UserFormula30                       3029      // char*, 99 Byte
-#define LOG_UserFormula30Active                 3128      // 1 Bit, Bit 7
+#define LOG_UserFormula30                       3031      // char*, 99 Byte
+#define LOG_UserFormula30Active                 3130      // 1 Bit, Bit 7
 #define     LOG_UserFormula30ActiveMask 0x80
 #define     LOG_UserFormula30ActiveShift 7
 
@@ -716,7 +807,7 @@
 #define LOG_ChannelCount 20
 
 // Parameter per channel
-#define LOG_ParamBlockOffset 3129
+#define LOG_ParamBlockOffset 3131
 #define LOG_ParamBlockSize 85
 #define LOG_ParamCalcIndex(index) (index + LOG_ParamBlockOffset + _channelIndex * LOG_ParamBlockSize)
 
@@ -2573,10 +2664,10 @@
 // Ausgang
 #define KoLOG_KOfO                                (knx.getGroupObject(LOG_KoCalcNumber(LOG_KoKOfO)))
 
-#define BTN_ReactionTimeMultiClick              4829      // 8 Bits, Bit 7-0
-#define BTN_ReactionTimeLong                    4830      // 8 Bits, Bit 7-0
-#define BTN_ReactionTimeExtraLong               4831      // 8 Bits, Bit 7-0
-#define BTN_VisibleChannels                     4832      // uint8_t
+#define BTN_ReactionTimeMultiClick              4831      // 8 Bits, Bit 7-0
+#define BTN_ReactionTimeLong                    4832      // 8 Bits, Bit 7-0
+#define BTN_ReactionTimeExtraLong               4833      // 8 Bits, Bit 7-0
+#define BTN_VisibleChannels                     4834      // uint8_t
 
 // Mehrfach-Klick
 #define ParamBTN_ReactionTimeMultiClick              (knx.paramByte(BTN_ReactionTimeMultiClick))
@@ -2590,7 +2681,7 @@
 #define BTN_ChannelCount 20
 
 // Parameter per channel
-#define BTN_ParamBlockOffset 4833
+#define BTN_ParamBlockOffset 4835
 #define BTN_ParamBlockSize 53
 #define BTN_ParamCalcIndex(index) (index + BTN_ParamBlockOffset + _channelIndex * BTN_ParamBlockSize)
 
@@ -3114,7 +3205,7 @@
 #define BASE_KommentarModuleModuleParamSize 0
 #define BASE_KommentarModuleSubmodulesParamSize 0
 #define BASE_KommentarModuleParamSize 0
-#define BASE_KommentarModuleParamOffset 5893
+#define BASE_KommentarModuleParamOffset 5895
 #define BASE_KommentarModuleCalcIndex(index, m1) (index + BASE_KommentarModuleParamOffset + _channelIndex * BASE_KommentarModuleCount * BASE_KommentarModuleParamSize + m1 * BASE_KommentarModuleParamSize)
 
 
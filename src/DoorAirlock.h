@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Airlock policy (DoorMode::AIRLOCK) over a snapshot of the door channels.
+// A door only opens once the drives of all others report CLOSED and none
+// is about to open; channels run in order, so the lower index wins a tie.
+// Someone waiting at a closed door makes the open one close as early as
+// possible (DOOR_OPEN_HOLD_MIN instead of the regular hold time).
+
+struct DoorAirlockChannel
+{
+    bool closed;     // the drive reports CLOSED
+    bool transition; // a command is pending (STATE_TRANSITION)
+    bool open;       // held open by the state machine (STATE_OPEN)
+    bool radar;      // an opening sensor of this door is active
+};
+
+template <size_t N>
+bool doorAirlockOpenAllowed(const DoorAirlockChannel (&channels)[N], uint8_t channel)
+{
+    for (uint8_t i = 0; i < N; i++)
+    {
+        if (i != channel && (!channels[i].closed || channels[i].transition))
+            return false;
+    }
+    return true;
+}
+
+template <size_t N>
+bool doorAirlockWaiting(const DoorAirlockChannel (&channels)[N], uint8_t channel)
+{
+    for (uint8_t i = 0; i < N; i++)
+    {
+        if (i != channel && !channels[i].open && channels[i].radar)
+            return true;
+    }
+    return false;
+}
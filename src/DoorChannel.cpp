@@ -0,0 +1,620 @@
+#include "DoorChannel.h"
+#include "DoorControllerModule.h"
+#include <cstring>
+
+void DoorChannel::setup(DoorControllerModule &controller, uint8_t index, const DoorSerialConfig &serialConfig)
+{
+    module = &controller;
+    channelIndex = index;
+
+    doorSerial.setMessageCallback([this](const uint8_t *payload, size_t length) {
+        this->doorMessageCallback(payload, length);
+    });
+    doorSerial.begin(serialConfig);
+}
+
+std::string DoorChannel::logPrefix()
+{
+    return "DoorChannel" + std::to_string(channelIndex);
+}
+
+void DoorChannel::doorMessageCallback(const uint8_t *payload, size_t length)
+{
+    // Only output the received command if it differs from the last one we saw.
+    if (length == DOOR_PAYLOAD_SIZE)
+    {
+        const DoorDriverState state = DoorActiveDriver::state(payload);
+        updateLatencyTraceReceived(state);
+
+        if (awaitingDoorResponse)
+        {
+            doorTiming.addSample(DoorTiming::METRIC_RESPONSE, millis() - lastDoorSent);
+            awaitingDoorResponse = false;
+        }
+
+        if (doorLinkLost)
+        {
+            doorLinkLost = false;
+            module->doorHistory.add(DoorHistory::Event::DRIVE_ERROR, DoorHistory::DRIVE_ERROR_LINK_RESTORED, channelIndex << 8);
+        }
+
+        if (module->doorDebugOutput ||
+            memcmp(payload, lastDataDoorReceived, DOOR_PAYLOAD_SIZE) != 0)
+        {
+            memcpy(lastDataDoorReceived, payload, DOOR_PAYLOAD_SIZE);
+            if (module->doorDebugDeferred)
+                module->doorEventLog.record(DoorLogEvent::FRAME_RECEIVED, lastDataDoorReceived, DOOR_PAYLOAD_SIZE);
+            else
+                doorLogHexDebugP("Door RECEIVED command changed:", lastDataDoorReceived, DOOR_PAYLOAD_SIZE);
+
+            switch (state)
+            {
+                case DoorDriverState::OPEN:
+                    doorState = DoorState::OPEN;
+                    break;
+
+                case DoorDriverState::CLOSED:
+                    doorState = DoorState::CLOSED;
+                    break;
+
+                case DoorDriverState::CLOSING:
+                    doorState = DoorState::CLOSING;
+                    break;
+
+                case DoorDriverState::OPENING:
+                    doorState = DoorState::OPENING;
+                    break;
+
+                default:
+                {
+                    const uint8_t rawState = DoorActiveDriver::rawState(lastDataDoorReceived);
+                    module->doorHistory.add(DoorHistory::Event::DRIVE_ERROR, DoorHistory::DRIVE_ERROR_UNKNOWN_STATE, channelIndex << 8 | rawState);
+                    if (module->doorDebugDeferred)
+                        module->doorEventLog.record(DoorLogEvent::UNKNOWN_DOOR_STATE, rawState);
+                    else
+                        logInfoP("Unknown door state received: %02X", rawState);
+                    break;
+                }
+            }
+
+            if (doorState != doorStatePrevious)
+                module->loopDirty |= DoorControllerModule::DIRTY_DOOR_STATE;
+        }
+
+        nextMessageReceived = true;
+    }
+    else
+    {
+        // Different length -> treat as changed: store what we can and print payload
+        size_t copyLen = std::min(length, DOOR_PAYLOAD_SIZE);
+        memset(lastDataDoorReceived, 0, DOOR_PAYLOAD_SIZE);
+        if (copyLen > 0)
+            memcpy(lastDataDoorReceived, payload, copyLen);
+
+        if (module->doorDebugDeferred)
+            module->doorEventLog.record(DoorLogEvent::FRAME_RECEIVED_LENGTH, payload, std::min(length, (size_t)DoorEventLog::DATA_SIZE));
+        else
+            doorLogHexDebugP("Door RECEIVED command with unexpected length:", payload, length);
+    }
+}
+
+bool DoorChannel::relayDriven()
+{
+    return channelIndex == 0 && module->doorRelay.enabled();
+}
+
+void DoorChannel::processRelay()
+{
+    DoorState state = DoorState::UNDEFINED;
+    switch (module->doorRelay.state(millis()))
+    {
+        case DoorDriverState::OPEN:
+            state = DoorState::OPEN;
+            break;
+
+        case DoorDriverState::CLOSED:
+            state = DoorState::CLOSED;
+            break;
+
+        case DoorDriverState::CLOSING:
+            state = DoorState::CLOSING;
+            break;
+
+        case DoorDriverState::OPENING:
+            state = DoorState::OPENING;
+            break;
+
+        default:
+            break;
+    }
+
+    if (doorState != state)
+    {
+        doorState = state;
+        module->loopDirty |= DoorControllerModule::DIRTY_DOOR_STATE;
+    }
+}
+
+void DoorChannel::processDoorSerial()
+{
+    if (relayDriven())
+    {
+        processRelay();
+        return;
+    }
+
+    doorSerial.poll();
+
+    // the drive answers every frame, wait a bit longer than it usually takes
+    const uint32_t sendTimeout = doorTiming.timeout(DoorTiming::METRIC_RESPONSE, DOOR_SEND_INTERVAL, DOOR_SEND_TIMEOUT);
+    bool timeout = lastDoorSent > 0 && delayCheckMillis(lastDoorSent, sendTimeout);
+    if (doorDataSendingHasData && (startSending || nextMessageReceived || timeout))
+    {
+        if (timeout)
+        {
+            if (module->doorDebugDeferred)
+                module->doorEventLog.record(DoorLogEvent::SEND_TIMEOUT);
+            else
+                doorLogDebugP("Door SEND timeout occurred");
+            doorSerial.countSendTimeout();
+            if (!doorLinkLost)
+            {
+                doorLinkLost = true;
+                module->doorHistory.add(DoorHistory::Event::DRIVE_ERROR, DoorHistory::DRIVE_ERROR_SEND_TIMEOUT, channelIndex << 8);
+            }
+        }
+
+        const uint8_t *payloadToSend = doorDataSending;
+
+        if (activeDoorPrefixes != nullptr && activeDoorPrefixIndex < activeDoorPrefixCount)
+        {
+            payloadToSend = activeDoorPrefixes[activeDoorPrefixIndex];
+            ++activeDoorPrefixIndex;
+        }
+
+        doorSerial.sendPayload(payloadToSend, DOOR_PAYLOAD_SIZE);
+        lastDoorSent = delayTimerInit();
+        awaitingDoorResponse = true;
+        updateLatencyTraceSent();
+
+        if (module->doorDebugOutput ||
+            memcmp(payloadToSend, lastDataDoorSent, DOOR_PAYLOAD_SIZE) != 0)
+        {
+            memcpy(lastDataDoorSent, payloadToSend, DOOR_PAYLOAD_SIZE);
+
+            if (module->doorDebugDeferred)
+                module->doorEventLog.record(DoorLogEvent::FRAME_SENT, lastDataDoorSent, DOOR_PAYLOAD_SIZE);
+            else
+                doorLogHexDebugP("Door SEND command changed:", lastDataDoorSent, DOOR_PAYLOAD_SIZE);
+        }
+
+        startSending = false;
+        nextMessageReceived = false;
+    }
+}
+
+bool DoorChannel::updateDoorState()
+{
+    if (doorStatePrevious == doorState)
+        return false;
+
+    module->doorHistory.add(DoorHistory::Event::DOOR_STATE, doorState, channelIndex);
+
+    if (doorState == DoorState::OPENING)
+        module->doorCounters.addCycle();
+    if (doorStatePrevious == DoorState::OPENING || doorStatePrevious == DoorState::CLOSING)
+        module->doorCounters.addRuntime(millis() - doorStateLastChanged);
+
+    if (doorStatePrevious == DoorState::OPENING && doorState == DoorState::OPEN)
+        doorTiming.addSample(DoorTiming::METRIC_OPENING, millis() - doorStateLastChanged);
+    else if (doorStatePrevious == DoorState::CLOSING && doorState == DoorState::CLOSED)
+        doorTiming.addSample(DoorTiming::METRIC_CLOSING, millis() - doorStateLastChanged);
+
+    doorStatePrevious = doorState;
+    doorStateChanged = true;
+    doorStateLastChanged = millis();
+    doorFsm.raise(FSM_EVENT_DOOR_STATE);
+    return true;
+}
+
+// Door state machine, see DoorFsm.h. Transitions of a state are evaluated in
+// table order, STATE_CLOSED_LOCKED inherits the transitions of STATE_CLOSED.
+constexpr uint8_t FSM_RECHECK = FSM_EVENT_ENTRY | FSM_EVENT_MODE;
+
+constexpr DoorFsmState<DoorChannel> DoorChannel::FSM_STATES[STATE_COUNT] = {
+    {"STATE_UNDEFINED", DOOR_FSM_NO_PARENT, nullptr, nullptr},
+    {"STATE_TRANSITION", DOOR_FSM_NO_PARENT, &DoorChannel::enterTransition, &DoorChannel::exitTransition},
+    {"STATE_OPEN", DOOR_FSM_NO_PARENT, &DoorChannel::enterOpen, &DoorChannel::exitOpen},
+    {"STATE_CLOSED", DOOR_FSM_NO_PARENT, nullptr, nullptr},
+    {"STATE_CLOSED_LOCKED", STATE_CLOSED, nullptr, nullptr},
+};
+
+constexpr DoorFsmTransition<DoorChannel> DoorChannel::FSM_TRANSITIONS[] = {
+    {STATE_UNDEFINED, FSM_EVENT_DOOR_STATE | FSM_RECHECK, &DoorChannel::guardDoorOpen, nullptr, STATE_OPEN},
+    {STATE_UNDEFINED, FSM_EVENT_DOOR_STATE | FSM_RECHECK, &DoorChannel::guardDoorClosed, nullptr, STATE_CLOSED},
+
+    {STATE_TRANSITION, FSM_EVENT_DOOR_STATE | FSM_EVENT_SENSOR | FSM_EVENT_INTERLOCK, &DoorChannel::guardPredictiveReopen, &DoorChannel::actionPredictiveReopen, STATE_TRANSITION},
+    {STATE_TRANSITION, FSM_EVENT_DOOR_STATE | FSM_EVENT_TIMER | FSM_RECHECK, &DoorChannel::guardTransitionOpen, nullptr, STATE_OPEN},
+    {STATE_TRANSITION, FSM_EVENT_DOOR_STATE | FSM_EVENT_TIMER | FSM_RECHECK, &DoorChannel::guardTransitionClosed, nullptr, STATE_CLOSED},
+    {STATE_TRANSITION, FSM_EVENT_TIMER, &DoorChannel::guardTransitionPending, &DoorChannel::actionArmTransitionTimer, STATE_TRANSITION},
+
+    {STATE_OPEN, FSM_EVENT_DOOR_STATE | FSM_RECHECK, &DoorChannel::guardDoorNotOpen, nullptr, STATE_UNDEFINED},
+    {STATE_OPEN, FSM_EVENT_SENSOR | FSM_EVENT_TIMER | FSM_RECHECK, &DoorChannel::guardAutomaticClose, &DoorChannel::actionClose, STATE_TRANSITION},
+    {STATE_OPEN, FSM_EVENT_SENSOR | FSM_EVENT_SWITCH | FSM_RECHECK, &DoorChannel::guardManualClose, &DoorChannel::actionClose, STATE_TRANSITION},
+    {STATE_OPEN, FSM_EVENT_SENSOR | FSM_EVENT_LOCK | FSM_RECHECK, &DoorChannel::guardLockClose, &DoorChannel::actionClose, STATE_TRANSITION},
+    {STATE_OPEN, FSM_EVENT_SENSOR | FSM_EVENT_TIMER, &DoorChannel::guardOpenHoldPending, &DoorChannel::actionArmOpenTimer, STATE_OPEN},
+
+    {STATE_CLOSED, FSM_EVENT_DOOR_STATE | FSM_RECHECK, &DoorChannel::guardDoorNotClosed, nullptr, STATE_UNDEFINED},
+    // a mode change must not open a door locked while the state machine did not run
+    {STATE_CLOSED, FSM_EVENT_LOCK | FSM_RECHECK, &DoorChannel::guardLocked, nullptr, STATE_CLOSED_LOCKED},
+    {STATE_CLOSED, FSM_EVENT_SENSOR | FSM_EVENT_TIMER | FSM_EVENT_INTERLOCK | FSM_RECHECK, &DoorChannel::guardPredictiveOpen, &DoorChannel::actionPredictiveOpen, STATE_TRANSITION},
+    {STATE_CLOSED, FSM_EVENT_SENSOR | FSM_EVENT_INTERLOCK | FSM_RECHECK, &DoorChannel::guardAutomaticOpen, &DoorChannel::actionOpen, STATE_TRANSITION},
+    {STATE_CLOSED, FSM_EVENT_SENSOR | FSM_EVENT_INTERLOCK | FSM_RECHECK, &DoorChannel::guardDirectionalOpen, &DoorChannel::actionOpen, STATE_TRANSITION},
+    {STATE_CLOSED, FSM_EVENT_SWITCH | FSM_EVENT_INTERLOCK | FSM_RECHECK, &DoorChannel::guardManualOpen, &DoorChannel::actionOpen, STATE_TRANSITION},
+
+    {STATE_CLOSED_LOCKED, FSM_EVENT_LOCK | FSM_EVENT_ENTRY, &DoorChannel::guardUnlocked, nullptr, STATE_CLOSED},
+    // a locked door stays closed, triggers are not passed to STATE_CLOSED
+    {STATE_CLOSED_LOCKED, FSM_EVENT_SENSOR | FSM_EVENT_SWITCH | FSM_EVENT_TIMER | FSM_EVENT_INTERLOCK | FSM_EVENT_MODE, nullptr, nullptr, STATE_CLOSED_LOCKED},
+};
+
+void DoorChannel::processDoorStateMachine(uint32_t now)
+{
+    static_assert(doorFsmStatesValid(FSM_STATES), "Door state machine: invalid state table");
+    static_assert(doorFsmTransitionsValid(FSM_TRANSITIONS, STATE_COUNT), "Door state machine: invalid transition table");
+    static_assert(doorFsmStatesReachable(FSM_TRANSITIONS, STATE_COUNT, STATE_UNDEFINED), "Door state machine: unreachable state");
+
+    if (fsmStateTimer.expired(now))
+        doorFsm.raise(FSM_EVENT_TIMER);
+
+    // transitions are only evaluated for new events, not on every loop,
+    // other channels may wait for this one (airlock)
+    if (doorFsm.pending() && doorFsm.dispatch(*this, FSM_STATES, FSM_TRANSITIONS) && DOOR_CHANNEL_COUNT > 1)
+        module->raiseChannels(FSM_EVENT_INTERLOCK);
+}
+
+bool DoorChannel::guardDoorOpen()
+{
+    return doorState == DoorState::OPEN;
+}
+
+bool DoorChannel::guardDoorClosed()
+{
+    return doorState == DoorState::CLOSED;
+}
+
+bool DoorChannel::guardDoorNotOpen()
+{
+    return doorState != DoorState::OPEN;
+}
+
+bool DoorChannel::guardDoorNotClosed()
+{
+    return doorState != DoorState::CLOSED;
+}
+
+bool DoorChannel::guardTransitionOpen()
+{
+    return doorState == DoorState::OPEN && !guardTransitionPending();
+}
+
+bool DoorChannel::guardTransitionClosed()
+{
+    return doorState == DoorState::CLOSED && !guardTransitionPending();
+}
+
+bool DoorChannel::guardTransitionPending()
+{
+    // the drive did not report a state change since the command and did not time out
+    return !doorStateChanged &&
+           !delayCheckMillis(doorStateLastChanged, doorTiming.timeout(DoorTiming::METRIC_COMMAND, DOOR_STATE_CHANGED_TIMEOUT_MIN, DOOR_STATE_CHANGED_TIMEOUT));
+}
+
+bool DoorChannel::guardPredictiveReopen()
+{
+    // reopen a closing door right away instead of waiting for CLOSED
+    if (module->doorMode != DoorControllerModule::DoorMode::AUTOMATIC || !ParamDOR_PredictiveOpening ||
+        doorState != DoorState::CLOSING || doorPreOpenSent || !module->openAllowed(channelIndex))
+        return false;
+
+    return module->doorPredictor.preOpenAllowed(module->doorPredictor.trigger(millis()));
+}
+
+bool DoorChannel::guardOpenHoldPending()
+{
+    return !delayCheckMillis(doorHoldSince(), doorOpenMin());
+}
+
+bool DoorChannel::guardAutomaticClose()
+{
+    return (module->doorMode == DoorControllerModule::DoorMode::AUTOMATIC ||
+            module->doorMode == DoorControllerModule::DoorMode::AIRLOCK ||
+            module->doorMode == DoorControllerModule::DoorMode::DIRECTIONAL) &&
+           !module->radarActive(channelIndex) && !module->airActive(channelIndex) &&
+           !guardOpenHoldPending() && module->doorSensorTest.passed();
+}
+
+bool DoorChannel::guardManualClose()
+{
+    return module->doorMode == DoorControllerModule::DoorMode::MANUAL &&
+           !module->sensorInsideAirActive && !module->sensorOutsideAirActive &&
+           (module->switchInsideTrigger || module->switchOutsideTrigger) &&
+           module->doorSensorTest.passed();
+}
+
+bool DoorChannel::guardLockClose()
+{
+    // no hold time, the lock request closes the door as soon as nobody is in the way
+    return module->doorLock.step() == DoorLock::LOCK_CLOSING &&
+           !module->radarActive(channelIndex) && !module->airActive(channelIndex) &&
+           module->doorSensorTest.passed();
+}
+
+bool DoorChannel::guardLocked()
+{
+    return module->lockActive;
+}
+
+bool DoorChannel::guardUnlocked()
+{
+    return !module->lockActive;
+}
+
+bool DoorChannel::guardPredictiveOpen()
+{
+    return module->doorMode == DoorControllerModule::DoorMode::AUTOMATIC && ParamDOR_PredictiveOpening &&
+           module->doorPredictor.trigger(millis()) != DoorPredictor::RADAR_COUNT &&
+           module->openAllowed(channelIndex);
+}
+
+bool DoorChannel::guardAutomaticOpen()
+{
+    // no predictive opening in airlock mode, the radars are assigned to the doors
+    return ((module->doorMode == DoorControllerModule::DoorMode::AUTOMATIC && !ParamDOR_PredictiveOpening) ||
+            module->doorMode == DoorControllerModule::DoorMode::AIRLOCK) &&
+           module->radarActive(channelIndex) &&
+           module->openAllowed(channelIndex);
+}
+
+bool DoorChannel::guardDirectionalOpen()
+{
+    // an approach from the blocked side leaves the door closed, see DoorDirection.h
+    return module->doorMode == DoorControllerModule::DoorMode::DIRECTIONAL &&
+           module->radarActive(channelIndex) &&
+           module->doorDirection.approaching(module->doorDirectionAllowed, millis()) &&
+           module->openAllowed(channelIndex);
+}
+
+bool DoorChannel::guardManualOpen()
+{
+    return module->doorMode == DoorControllerModule::DoorMode::MANUAL &&
+           (module->switchInsideTrigger || module->switchOutsideTrigger) &&
+           module->openAllowed(channelIndex);
+}
+
+void DoorChannel::enterTransition()
+{
+    actionArmTransitionTimer();
+}
+
+void DoorChannel::exitTransition()
+{
+    fsmStateTimer.stop();
+    doorPreOpenSent = false;
+}
+
+void DoorChannel::enterOpen()
+{
+    doorOpenSince = millis();
+    // traffic statistics are kept for the door, not per leaf
+    if (channelIndex == 0)
+        module->doorTraffic.opened(doorOpenSince, doorOpenBase(), learnedTime(DoorTiming::METRIC_OPENING),
+                                   learnedTime(DoorTiming::METRIC_CLOSING));
+    // runs during the hold time, see DoorSensorTest.h
+    module->doorSensorTest.request(module->sensorTestSensors());
+    actionArmOpenTimer();
+}
+
+void DoorChannel::exitOpen()
+{
+    fsmStateTimer.stop();
+}
+
+void DoorChannel::actionPredictiveReopen()
+{
+    logDebugP("Predictive reopen while closing");
+    module->doorPredictor.cycleOpened(module->doorPredictor.trigger(millis()));
+    sendMainMld(true);
+    doorPreOpenSent = true;
+    actionArmTransitionTimer();
+}
+
+void DoorChannel::actionArmTransitionTimer()
+{
+    // the learned timeout may have changed since the timer was armed
+    fsmStateTimer.start(doorStateLastChanged, doorTiming.timeout(DoorTiming::METRIC_COMMAND, DOOR_STATE_CHANGED_TIMEOUT_MIN, DOOR_STATE_CHANGED_TIMEOUT));
+}
+
+void DoorChannel::actionArmOpenTimer()
+{
+    fsmStateTimer.start(doorHoldSince(), doorOpenMin());
+}
+
+void DoorChannel::actionClose()
+{
+    module->doorPredictor.cycleClosed();
+    if (channelIndex == 0)
+        module->doorTraffic.closed(millis());
+    // all leaves see the switch trigger, it is cleared after all channels ran
+    module->switchTriggerUsed = true;
+    sendMainMld(true);
+}
+
+void DoorChannel::actionPredictiveOpen()
+{
+    module->doorPredictor.cycleOpened(module->doorPredictor.trigger(millis()));
+    sendMainMld(true);
+}
+
+void DoorChannel::actionOpen()
+{
+    module->switchTriggerUsed = true;
+    sendMainMld(true);
+}
+
+bool DoorChannel::adaptiveHold()
+{
+    return module->doorMode == DoorControllerModule::DoorMode::AUTOMATIC && ParamDOR_AdaptiveHold &&
+           !module->airlockWaiting(channelIndex);
+}
+
+uint32_t DoorChannel::doorHoldSince()
+{
+    // the adaptive hold counts from the last trigger while open, see DoorTraffic.h
+    const uint32_t lastTrigger = module->doorTraffic.lastTrigger();
+    if (adaptiveHold() && (int32_t)(lastTrigger - doorOpenSince) > 0)
+        return lastTrigger;
+    return doorOpenSince;
+}
+
+uint32_t DoorChannel::doorOpenMin()
+{
+    if (module->airlockWaiting(channelIndex))
+        return DOOR_OPEN_HOLD_MIN;
+    if (adaptiveHold())
+        return module->doorTraffic.holdTime(doorOpenBase(), ParamDOR_AdaptiveHoldMax * 1000UL);
+    return doorOpenBase();
+}
+
+uint32_t DoorChannel::learnedTime(DoorTiming::Metric metric)
+{
+    return doorTiming.learned(metric) ? doorTiming.mean(metric) : 0;
+}
+
+uint32_t DoorChannel::doorOpenBase()
+{
+    // DOOR_OPEN_MIN is meant from the open command on, a fast drive spends
+    // less of it opening, so it is counted from OPEN minus the learned opening time
+    if (!doorTiming.learned(DoorTiming::METRIC_OPENING))
+        return DOOR_OPEN_MIN;
+
+    const uint32_t opening = doorTiming.mean(DoorTiming::METRIC_OPENING);
+    if (opening >= DOOR_OPEN_MIN - DOOR_OPEN_HOLD_MIN)
+        return DOOR_OPEN_HOLD_MIN;
+    return DOOR_OPEN_MIN - opening;
+}
+
+void DoorChannel::sendMainMld(bool active)
+{
+    // #ToDo
+    if (!active)
+        return;
+
+    doorStateChanged = false;
+    doorStateLastChanged = millis();
+
+    const bool close = doorState == DoorState::OPEN || doorState == DoorState::OPENING;
+    if (relayDriven())
+    {
+        // the drive toggles on every impulse
+        module->doorRelay.pulse(DoorRelay::MLD);
+        module->doorRelay.moved(!close, doorStateLastChanged);
+        return;
+    }
+
+    if (close)
+    {
+        setDoorCommand(module->doorCommands.command(DOOR_COMMAND_CLOSING));
+        startLatencyTrace(micros(), DoorDriverState::CLOSING);
+    }
+    else
+    {
+        setDoorCommand(module->doorCommands.command(DOOR_COMMAND_OPENING));
+        // a sensor change is traced from its ISR timestamp, timer, switch, interlock
+        // and the other events have none and are traced from now on
+        const bool sensor = doorFsm.event() == FSM_EVENT_SENSOR;
+        startLatencyTrace(sensor ? module->sensorEventAt : micros(), DoorDriverState::OPENING);
+    }
+}
+
+void DoorChannel::setDoorCommand(const DoorCommandDefinition &definition)
+{
+    activeDoorPrefixes = (definition.prefixCount > 0 && definition.prefixPayloads != nullptr) ? definition.prefixPayloads : nullptr;
+    activeDoorPrefixCount = (definition.prefixCount > 0 && definition.prefixPayloads != nullptr) ? definition.prefixCount : 0;
+    activeDoorPrefixIndex = 0;
+
+    if (definition.finalPayload != nullptr)
+        memcpy(doorDataSending, definition.finalPayload, DOOR_PAYLOAD_SIZE);
+    else
+        memset(doorDataSending, 0, DOOR_PAYLOAD_SIZE);
+    doorDataSendingHasData = true;
+
+    memset(lastDataDoorSent, 0, sizeof(lastDataDoorSent));
+    startSending = true;
+}
+
+void DoorChannel::printTiming()
+{
+    doorTiming.printStatus();
+    logInfoP("Effective: send timeout %lu ms, state change timeout %lu ms, open min %lu ms",
+             doorTiming.timeout(DoorTiming::METRIC_RESPONSE, DOOR_SEND_INTERVAL, DOOR_SEND_TIMEOUT),
+             doorTiming.timeout(DoorTiming::METRIC_COMMAND, DOOR_STATE_CHANGED_TIMEOUT_MIN, DOOR_STATE_CHANGED_TIMEOUT),
+             doorOpenMin());
+}
+
+void DoorChannel::printTrace()
+{
+    doorFsm.printTrace(FSM_STATES);
+}
+
+void DoorChannel::startLatencyTrace(uint32_t triggeredAt, DoorDriverState expectedState)
+{
+    if (latencyTrace.active)
+        module->latencyTraceTimeouts++;
+
+    latencyTrace.id = ++module->latencyTraceId;
+    latencyTrace.triggeredAt = triggeredAt;
+    latencyTrace.sentAt = 0;
+    latencyTrace.expectedState = expectedState;
+    latencyTrace.active = true;
+    latencyTrace.sent = false;
+}
+
+void DoorChannel::updateLatencyTraceSent()
+{
+    if (!latencyTrace.active)
+        return;
+
+    const uint32_t now = micros();
+    if (now - latencyTrace.triggeredAt >= DOOR_STATE_CHANGED_TIMEOUT * 1000UL)
+    {
+        logDebugP("Latency trace #%u timed out", latencyTrace.id);
+        latencyTrace.active = false;
+        module->latencyTraceTimeouts++;
+        return;
+    }
+
+    // only the first frame of a command counts (prefix or final payload),
+    // sendPayload flushes the UART, so the frame has left the device here
+    if (latencyTrace.sent)
+        return;
+
+    latencyTrace.sentAt = now;
+    latencyTrace.sent = true;
+    module->latencyTriggerToSend.record(now - latencyTrace.triggeredAt);
+}
+
+void DoorChannel::updateLatencyTraceReceived(DoorDriverState state)
+{
+    if (!latencyTrace.active || !latencyTrace.sent || state != latencyTrace.expectedState)
+        return;
+
+    // timestamp is taken when the frame is decoded in processDoorSerial,
+    // so it includes up to one loop iteration of delay
+    const uint32_t now = micros();
+    module->latencySendToDrive.record(now - latencyTrace.sentAt);
+    module->latencyTriggerToDrive.record(now - latencyTrace.triggeredAt);
+    doorTiming.addSample(DoorTiming::METRIC_COMMAND, (now - latencyTrace.sentAt) / 1000);
+    latencyTrace.active = false;
+
+    logDebugP("Latency trace #%u: trigger->send %lu us, send->drive %lu us", latencyTrace.id, latencyTrace.sentAt - latencyTrace.triggeredAt, now - latencyTrace.sentAt);
+}
@@ -0,0 +1,167 @@
+#pragma once
+#include <Arduino.h>
+#include <cstddef>
+#include <cstdint>
+#include "OpenKNX.h"
+#include "hardware.h"
+#include "DoorDrivers.h"
+#include "DoorSerial.h"
+#include "DoorTiming.h"
+#include "DoorFsm.h"
+
+#define DOOR_SEND_INTERVAL 60
+#define DOOR_SEND_TIMEOUT 150
+
+class DoorControllerModule;
+
+// DoorChannel is one door leaf with its own drive: serial link, state
+// reported by the drive, learned drive timing and door state machine.
+// Sensors, door mode, lock, history, counters and KOs are shared by all
+// channels and stay in DoorControllerModule, which owns a fixed array of
+// DOOR_CHANNEL_COUNT channels, so memory grows linearly with the channel
+// count and no channel needs heap memory.
+
+class DoorChannel
+{
+  public:
+    enum DoorState
+    {
+        CLOSED,
+        CLOSING,
+        OPEN,
+        OPENING,
+        UNDEFINED
+    };
+
+    // order must match FSM_STATES, see DoorChannel.cpp
+    enum DoorStateMachine : uint8_t
+    {
+        STATE_UNDEFINED,
+        STATE_TRANSITION,
+        STATE_OPEN,
+        STATE_CLOSED,
+        STATE_CLOSED_LOCKED, // child of STATE_CLOSED
+        STATE_COUNT
+    };
+
+    void setup(DoorControllerModule &controller, uint8_t index, const DoorSerialConfig &serialConfig);
+    void processDoorSerial();
+    // returns true if the drive reported a new state since the last call
+    bool updateDoorState();
+    void processDoorStateMachine(uint32_t now);
+    void setDoorCommand(const DoorCommandDefinition &definition);
+    // prefixes still to send point into the definition, nullptr: any definition
+    inline bool prefixesPending(const uint8_t *const *prefixes = nullptr) const
+    {
+        return activeDoorPrefixes != nullptr && activeDoorPrefixIndex < activeDoorPrefixCount &&
+               (prefixes == nullptr || activeDoorPrefixes == prefixes);
+    }
+    uint32_t doorOpenMin();
+
+    inline void raise(uint8_t events) { doorFsm.raise(events); }
+    inline void discardEvents() { doorFsm.discard(); }
+    inline DoorState state() const { return doorState; }
+    inline DoorStateMachine machineState() const { return static_cast<DoorStateMachine>(doorFsm.state()); }
+    inline const char *machineStateName() const { return FSM_STATES[doorFsm.state()].name; }
+    inline uint8_t index() const { return channelIndex; }
+    inline DoorSerial &serial() { return doorSerial; }
+    inline DoorTiming &timing() { return doorTiming; }
+
+    void printTiming();
+    void printTrace();
+    std::string logPrefix();
+
+  private:
+    DoorControllerModule *module = nullptr;
+    uint8_t channelIndex = 0;
+    DoorSerial doorSerial;
+    DoorTiming doorTiming;
+
+    DoorState doorState = DoorState::UNDEFINED;
+    DoorState doorStatePrevious = DoorState::UNDEFINED;
+    bool doorStateChanged = false;
+    unsigned long doorStateLastChanged = 0;
+    unsigned long doorOpenSince = 0;
+    bool doorPreOpenSent = false;
+    DoorFsm<DoorChannel> doorFsm = DoorFsm<DoorChannel>(STATE_UNDEFINED);
+    DoorFsmTimer fsmStateTimer;
+
+    uint32_t lastDoorSent = 0;
+    bool startSending = false;
+    bool nextMessageReceived = false;
+    bool awaitingDoorResponse = false;
+    // history records link edges only, an unplugged drive times out every frame
+    bool doorLinkLost = false;
+    bool doorDataSendingHasData = false;
+    uint8_t doorDataSending[DOOR_PAYLOAD_SIZE] = {};
+    uint8_t lastDataDoorSent[DOOR_PAYLOAD_SIZE] = {};
+    uint8_t lastDataDoorReceived[DOOR_PAYLOAD_SIZE] = {};
+
+    const uint8_t *const *activeDoorPrefixes = nullptr;
+    size_t activeDoorPrefixCount = 0;
+    size_t activeDoorPrefixIndex = 0;
+
+    // end-to-end latency from trigger (e.g. radar edge) to command frame on
+    // the UART and further to the matching state reported by the drive (us)
+    struct DoorLatencyTrace
+    {
+        uint16_t id;
+        uint32_t triggeredAt;
+        uint32_t sentAt;
+        DoorDriverState expectedState;
+        bool active;
+        bool sent;
+    };
+
+    DoorLatencyTrace latencyTrace = {};
+
+    void doorMessageCallback(const uint8_t *payload, size_t length);
+    // contact interface instead of the serial link, see DoorRelay
+    bool relayDriven();
+    void processRelay();
+    void sendMainMld(bool active);
+    uint32_t doorOpenBase();
+    // learned mean of a drive time, 0 until enough samples are known
+    uint32_t learnedTime(DoorTiming::Metric metric);
+    bool adaptiveHold();
+    // start of the hold time doorOpenMin()
+    uint32_t doorHoldSince();
+    void startLatencyTrace(uint32_t triggeredAt, DoorDriverState expectedState);
+    void updateLatencyTraceSent();
+    void updateLatencyTraceReceived(DoorDriverState state);
+
+    static const DoorFsmState<DoorChannel> FSM_STATES[STATE_COUNT];
+    static const DoorFsmTransition<DoorChannel> FSM_TRANSITIONS[];
+
+    // state machine guards
+    bool guardDoorOpen();
+    bool guardDoorClosed();
+    bool guardDoorNotOpen();
+    bool guardDoorNotClosed();
+    bool guardTransitionOpen();
+    bool guardTransitionClosed();
+    bool guardTransitionPending();
+    bool guardPredictiveReopen();
+    bool guardOpenHoldPending();
+    bool guardAutomaticClose();
+    bool guardManualClose();
+    bool guardLockClose();
+    bool guardLocked();
+    bool guardUnlocked();
+    bool guardPredictiveOpen();
+    bool guardAutomaticOpen();
+    bool guardDirectionalOpen();
+    bool guardManualOpen();
+
+    // state machine actions
+    void enterTransition();
+    void exitTransition();
+    void enterOpen();
+    void exitOpen();
+    void actionPredictiveReopen();
+    void actionArmTransitionTimer();
+    void actionArmOpenTimer();
+    void actionClose();
+    void actionPredictiveOpen();
+    void actionOpen();
+};
@@ -0,0 +1,109 @@
+#include "DoorCommandTable.h"
+#include "DoorPersistence.h"
+#include <LittleFS.h>
+#include <cstring>
+
+DoorCommandTable::DoorCommandTable()
+{
+    reset();
+}
+
+void DoorCommandTable::reset()
+{
+    for (uint8_t i = 0; i < DOOR_COMMAND_COUNT; i++)
+        _commands[i] = DoorActiveDriver::command(static_cast<DoorCommandId>(i));
+    _payloadCount = 0;
+    _loaded = false;
+}
+
+const char *DoorCommandTable::validate(const uint8_t *data, size_t size)
+{
+    if (size < sizeof(Header) + 2)
+        return "too short";
+
+    Header header;
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != DOOR_COMMAND_TABLE_MAGIC || header.version != DOOR_COMMAND_TABLE_VERSION)
+        return "unknown format";
+    if (header.payloadSize != DOOR_PAYLOAD_SIZE)
+        return "payload size mismatch";
+    if (header.payloadCount == 0 || header.payloadCount > DOOR_COMMAND_PAYLOAD_MAX)
+        return "invalid payload count";
+    if (header.commandCount != DOOR_COMMAND_COUNT)
+        return "command count mismatch";
+    if (size != sizeof(Header) + header.payloadCount * DOOR_PAYLOAD_SIZE + DOOR_COMMAND_COUNT * sizeof(Command) + 2)
+        return "size mismatch";
+
+    const uint16_t crc = data[size - 2] | data[size - 1] << 8;
+    if (crc != doorFlashCrc16(data, size - 2))
+        return "CRC mismatch";
+
+    const Command *commands = reinterpret_cast<const Command *>(data + sizeof(Header) + header.payloadCount * DOOR_PAYLOAD_SIZE);
+    for (uint8_t i = 0; i < DOOR_COMMAND_COUNT; i++)
+    {
+        if (commands[i].finalPayload >= header.payloadCount || commands[i].prefixCount > DOOR_COMMAND_PREFIX_MAX)
+            return "invalid command";
+
+        for (uint8_t j = 0; j < commands[i].prefixCount; j++)
+        {
+            if (commands[i].prefixPayloads[j] >= header.payloadCount)
+                return "invalid command";
+        }
+    }
+
+    return nullptr;
+}
+
+bool DoorCommandTable::load()
+{
+    if (!LittleFS.exists(DOOR_COMMAND_TABLE_PATH))
+    {
+        logDebugP("No command table, using built-in commands");
+        return false;
+    }
+
+    File file = LittleFS.open(DOOR_COMMAND_TABLE_PATH, "r");
+    uint8_t data[FILE_SIZE_MAX];
+    const size_t size = file ? file.read(data, sizeof(data)) : 0;
+    const bool complete = file && file.available() == 0;
+    file.close();
+
+    const char *error = complete ? validate(data, size) : "too long";
+    if (error != nullptr)
+    {
+        logErrorP("Command table %s rejected: %s", DOOR_COMMAND_TABLE_PATH, error);
+        return false;
+    }
+
+    Header header;
+    memcpy(&header, data, sizeof(header));
+    _payloadCount = header.payloadCount;
+    memcpy(_payloads, data + sizeof(Header), _payloadCount * DOOR_PAYLOAD_SIZE);
+
+    const Command *commands = reinterpret_cast<const Command *>(data + sizeof(Header) + _payloadCount * DOOR_PAYLOAD_SIZE);
+    for (uint8_t i = 0; i < DOOR_COMMAND_COUNT; i++)
+    {
+        for (uint8_t j = 0; j < commands[i].prefixCount; j++)
+            _prefixes[i][j] = _payloads[commands[i].prefixPayloads[j]];
+
+        _commands[i] = {_payloads[commands[i].finalPayload], commands[i].prefixCount, commands[i].prefixCount > 0 ? _prefixes[i] : nullptr};
+    }
+
+    _loaded = true;
+    logInfoP("Command table loaded: %u payloads", _payloadCount);
+    return true;
+}
+
+void DoorCommandTable::printStatus()
+{
+    logInfoP("Command table: %s", _loaded ? DOOR_COMMAND_TABLE_PATH : "built-in");
+    logIndentUp();
+    for (uint8_t i = 0; i < DOOR_COMMAND_COUNT; i++)
+    {
+        logInfoP("Command %u: %u prefixes", i, _commands[i].prefixCount);
+        for (size_t j = 0; j < _commands[i].prefixCount; j++)
+            logHexInfoP(_commands[i].prefixPayloads[j], DOOR_PAYLOAD_SIZE);
+        logHexInfoP(_commands[i].finalPayload, DOOR_PAYLOAD_SIZE);
+    }
+    logIndentDown();
+}
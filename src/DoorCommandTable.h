@@ -0,0 +1,72 @@
+#pragma once
+#include <Arduino.h>
+#include <cstddef>
+#include <cstdint>
+#include "OpenKNX.h"
+#include "DoorDrivers.h"
+
+#define DOOR_COMMAND_TABLE_PATH "/door/commands.bin"
+#define DOOR_COMMAND_TABLE_MAGIC 0x444D4344 // "DCMD"
+#define DOOR_COMMAND_TABLE_VERSION 1
+#define DOOR_COMMAND_PAYLOAD_MAX 32
+#define DOOR_COMMAND_PREFIX_MAX 4
+
+// DoorCommandTable holds the command set sent to the drive, indexed by
+// DoorCommandId. It starts with the built-in commands of the drive driver;
+// another drive variant or firmware revision can replace them without a
+// rebuild by a binary table in LittleFS (DOOR_COMMAND_TABLE_PATH, e.g.
+// uploaded via FileTransferModule). All values little endian:
+//
+//   magic (4), version (1), payload size (1), payload count P (1), command count C (1)
+//   P payloads of DOOR_PAYLOAD_SIZE bytes
+//   C commands in DoorCommandId order: final payload index (1), prefix count (1),
+//     DOOR_COMMAND_PREFIX_MAX prefix payload indexes (unused 0xFF)
+//   CRC16-CCITT over everything before (2, see doorFlashCrc16)
+//
+// The table is only accepted as a whole. LittleFS files are not contiguous
+// in flash and cannot be mapped from XIP, so the few hundred bytes are copied
+// to RAM once; command() is an array access like the built-in constants.
+
+class DoorCommandTable
+{
+  public:
+    DoorCommandTable();
+
+    inline const DoorCommandDefinition &command(DoorCommandId id) const { return _commands[id]; }
+    inline bool loaded() const { return _loaded; }
+
+    // false keeps the current table; replaces the payloads in place, no
+    // channel may send prefixes of the current table (DoorChannel::prefixesPending)
+    bool load();
+    void reset();
+    void printStatus();
+
+    std::string logPrefix() { return "DoorCommandTable"; }
+
+  private:
+    struct __attribute__((packed)) Header
+    {
+        uint32_t magic;
+        uint8_t version;
+        uint8_t payloadSize;
+        uint8_t payloadCount;
+        uint8_t commandCount;
+    };
+
+    struct __attribute__((packed)) Command
+    {
+        uint8_t finalPayload;
+        uint8_t prefixCount;
+        uint8_t prefixPayloads[DOOR_COMMAND_PREFIX_MAX];
+    };
+
+    static constexpr size_t FILE_SIZE_MAX = sizeof(Header) + DOOR_COMMAND_PAYLOAD_MAX * DOOR_PAYLOAD_SIZE + DOOR_COMMAND_COUNT * sizeof(Command) + 2;
+
+    DoorCommandDefinition _commands[DOOR_COMMAND_COUNT];
+    uint8_t _payloads[DOOR_COMMAND_PAYLOAD_MAX][DOOR_PAYLOAD_SIZE] = {};
+    const uint8_t *_prefixes[DOOR_COMMAND_COUNT][DOOR_COMMAND_PREFIX_MAX] = {};
+    uint8_t _payloadCount = 0;
+    bool _loaded = false;
+
+    const char *validate(const uint8_t *data, size_t size);
+};
@@ -0,0 +1,140 @@
+#pragma once
+#include <Arduino.h>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "OpenKNX.h"
+
+// Console dispatch without allocations. Commands are a constexpr table of
+// the owner (see DoorControllerModule.cpp), DoorLookup builds an open
+// addressing hash index over the entry names at compile time. A line is
+// matched against the longest command it starts with, the rest of the line
+// are the arguments. The same table generates the help output.
+
+// FNV-1a
+constexpr uint32_t doorConsoleHash(std::string_view text)
+{
+    uint32_t hash = 2166136261u;
+    for (const char c : text)
+    {
+        hash ^= (uint8_t)c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+template <typename Owner>
+struct DoorConsoleCommand
+{
+    const char *name;
+    const char *args; // usage of the arguments, nullptr if there are none
+    const char *help;
+    bool (Owner::*handler)(std::string_view args, bool diagnoseKo);
+};
+
+// Entry needs a member name, N entries at most 254
+template <typename Entry, size_t N>
+class DoorLookup
+{
+  public:
+    static constexpr uint8_t EMPTY = 0xFF;
+
+    constexpr explicit DoorLookup(const Entry (&entries)[N]) : _entries(entries)
+    {
+        for (size_t i = 0; i < SLOTS; i++)
+            _slots[i] = EMPTY;
+
+        for (size_t i = 0; i < N; i++)
+        {
+            _hashes[i] = doorConsoleHash(entries[i].name);
+            size_t slot = _hashes[i] & (SLOTS - 1);
+            while (_slots[slot] != EMPTY)
+                slot = (slot + 1) & (SLOTS - 1);
+            _slots[slot] = i;
+        }
+    }
+
+    // all names differ in their hash, so a lookup compares one string at most
+    constexpr bool valid() const
+    {
+        if (N >= EMPTY)
+            return false;
+
+        for (size_t i = 0; i < N; i++)
+        {
+            for (size_t j = i + 1; j < N; j++)
+            {
+                if (_hashes[i] == _hashes[j])
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    const Entry *find(std::string_view name) const
+    {
+        const uint32_t hash = doorConsoleHash(name);
+        for (size_t slot = hash & (SLOTS - 1); _slots[slot] != EMPTY; slot = (slot + 1) & (SLOTS - 1))
+        {
+            const uint8_t index = _slots[slot];
+            if (_hashes[index] == hash)
+                return name == _entries[index].name ? &_entries[index] : nullptr;
+        }
+        return nullptr;
+    }
+
+    // longest entry the line starts with (followed by a space), args is the rest
+    const Entry *findPrefix(std::string_view line, std::string_view &args) const
+    {
+        std::string_view name = line;
+        while (true)
+        {
+            const Entry *entry = find(name);
+            if (entry != nullptr)
+            {
+                args = line.substr(name.size());
+                while (!args.empty() && args.front() == ' ')
+                    args.remove_prefix(1);
+                return entry;
+            }
+
+            const size_t space = name.rfind(' ');
+            if (space == std::string_view::npos)
+                return nullptr;
+            name = name.substr(0, space);
+        }
+    }
+
+  private:
+    static constexpr size_t slotCount()
+    {
+        // power of two, at most half full
+        size_t slots = 4;
+        while (slots < N * 2)
+            slots *= 2;
+        return slots;
+    }
+
+    static constexpr size_t SLOTS = slotCount();
+
+    const Entry *_entries;
+    uint32_t _hashes[N] = {};
+    uint8_t _slots[SLOTS] = {};
+};
+
+template <typename Owner, size_t N>
+void doorConsolePrintHelp(const DoorConsoleCommand<Owner> (&commands)[N])
+{
+    for (const DoorConsoleCommand<Owner> &command : commands)
+    {
+        if (command.args == nullptr)
+        {
+            logInfo(command.name, command.help);
+            continue;
+        }
+
+        char usage[64];
+        snprintf(usage, sizeof(usage), "%s %s", command.name, command.args);
+        logInfo(usage, command.help);
+    }
+}
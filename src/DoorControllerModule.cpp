@@ -5,48 +5,7 @@
 
 namespace
 {
-static_assert(DOOR_PAYLOAD_SIZE == sizeof(PAYLOAD_INIT1), "Door payload size mismatch");
-static_assert(DOOR_PAYLOAD_SIZE == sizeof(PAYLOAD_INIT2), "Door payload size mismatch");
-static_assert(DOOR_PAYLOAD_SIZE == sizeof(PAYLOAD_INIT3), "Door payload size mismatch");
-static_assert(DOOR_PAYLOAD_SIZE == sizeof(PAYLOAD_OPEN), "Door payload size mismatch");
-static_assert(DOOR_PAYLOAD_SIZE == sizeof(PAYLOAD_CLOSING), "Door payload size mismatch");
-static_assert(DOOR_PAYLOAD_SIZE == sizeof(PAYLOAD_CLOSED), "Door payload size mismatch");
-static_assert(DOOR_PAYLOAD_SIZE == sizeof(PAYLOAD_OPENING), "Door payload size mismatch");
-
-template <typename T, size_t N>
-constexpr size_t arrayCount(const T (&)[N])
-{
-    return N;
-}
-
-// Define prefix message sequences here. Each entry is transmitted once (in order)
-// before the final payload is sent continuously again.
-constexpr const uint8_t *PREFIX_CLOSING[] = {PAYLOAD_CLOSING_PRE1, PAYLOAD_CLOSING_PRE2};
-constexpr const uint8_t *PREFIX_OPENING[] = {PAYLOAD_OPENING_PRE1};
-
-constexpr DoorCommandDefinition COMMAND_INIT1{PAYLOAD_INIT1, 0u, nullptr};
-constexpr DoorCommandDefinition COMMAND_INIT2{PAYLOAD_INIT2, 0u, nullptr};
-constexpr DoorCommandDefinition COMMAND_INIT3{PAYLOAD_INIT3, 0u, nullptr};
-constexpr DoorCommandDefinition COMMAND_OPEN{PAYLOAD_OPEN, 0u, nullptr};
-constexpr DoorCommandDefinition COMMAND_CLOSING{PAYLOAD_CLOSING, arrayCount(PREFIX_CLOSING), PREFIX_CLOSING};
-constexpr DoorCommandDefinition COMMAND_CLOSED{PAYLOAD_CLOSED, 0u, nullptr};
-constexpr DoorCommandDefinition COMMAND_OPENING{PAYLOAD_OPENING, arrayCount(PREFIX_OPENING), PREFIX_OPENING};
-
-struct CommandLookupEntry
-{
-    const char *token;
-    const DoorCommandDefinition *definition;
-};
-
-constexpr CommandLookupEntry COMMAND_LOOKUP[] = {
-    {"it1", &COMMAND_INIT1},
-    {"it2", &COMMAND_INIT2},
-    {"it3", &COMMAND_INIT3},
-    {"opg", &COMMAND_OPENING},
-    {"opn", &COMMAND_OPEN},
-    {"clg", &COMMAND_CLOSING},
-    {"cls", &COMMAND_CLOSED},
-};
+const DoorSerialConfig CHANNEL_SERIALS[DOOR_CHANNEL_COUNT] = {DOOR_CHANNEL_SERIALS};
 } // namespace
 
 const std::string DoorControllerModule::name()
@@ -75,11 +34,23 @@ void DoorControllerModule::setup()
     openknx.gpio.pinMode(SENSOR_OUTSIDE_RAD_PIN, INPUT_PULLUP);
     openknx.gpio.pinMode(SENSOR_OUTSIDE_AIR_PIN, INPUT_PULLUP);
 
-    doorSerial.setMessageCallback([this](const std::vector<uint8_t>& payload) {
-        this->doorMessageCallback(payload);
-    });
+    for (uint8_t i = 0; i < DOOR_CHANNEL_COUNT; i++)
+        channels[i].setup(*this, i, CHANNEL_SERIALS[i]);
+    if (ParamDOR_DriveInterface == 1)
+        doorRelay.begin();
+    if (ParamDOR_SensorTest)
+        doorSensorTest.begin();
+
+    // the four parameters of a function are consecutive bits in SensorBit order
+    sensorRoutes[ROUTE_OPEN] = (knx.paramByte(DOR_RouteOpenInsideRad) >> DOR_RouteOpenInsideRadShift) & SENSOR_BITS_ALL;
+    sensorRoutes[ROUTE_HSK] = (knx.paramByte(DOR_RouteHskInsideRad) >> DOR_RouteHskInsideRadShift) & SENSOR_BITS_ALL;
+    sensorRoutes[ROUTE_NSK] = (knx.paramByte(DOR_RouteNskInsideRad) >> DOR_RouteNskInsideRadShift) & SENSOR_BITS_ALL;
 
-    doorSerial.begin();
+    doorHistory.begin();
+    doorCommands.load();
+    doorScript.begin(doorCommands, [](const uint8_t *const *prefixes) { return openknxDoorControllerModule.prefixesPending(prefixes); });
+    doorCounters.begin();
+    updateCounters(false);
 
     logDebugP("Get initial sensor states");
     sensorInsideRadActiveNew = openknx.gpio.digitalRead(SENSOR_INSIDE_RAD_PIN) == SENSOR_RAD_ACTIVE;
@@ -108,6 +79,16 @@ void DoorControllerModule::processInputKo(GroupObject &ko)
             doorMode = static_cast<DoorMode>((byte)KoDOR_DoorMode.value(DPT_DecimalFactor));
             KoDOR_DoorModeStatus.valueNoSend((byte)doorMode, DPT_DecimalFactor);
             logDebugP("DoorMode changed: %d", doorMode);
+            if (doorMode == DoorMode::AIRLOCK)
+                warnRelayState("Airlock interlock");
+            raiseChannels(FSM_EVENT_MODE);
+            loopDirty |= DIRTY_OUTPUTS;
+            doorHistory.add(DoorHistory::Event::DOOR_MODE, doorMode);
+            doorEvents.publish(DoorEvents::DOOR_MODE, doorMode);
+            break;
+        case DOR_KoDoorDirection:
+            applyDoorDirection((byte)KoDOR_DoorDirection.value(DPT_Value_1_Ucount) == 1 ? DoorDirection::ENTRY : DoorDirection::EXIT);
+            logDebugP("DoorDirection changed: %d", doorDirectionAllowed);
             break;
         case DOR_KoSwitchInside:
             // switch trigger can only be used in manual door mode
@@ -116,6 +97,7 @@ void DoorControllerModule::processInputKo(GroupObject &ko)
 
             // switch trigger can only be set, not reset externally
             switchInsideTrigger = KoDOR_SwitchInside.value(DPT_Switch) ? true : switchInsideTrigger;
+            raiseChannels(FSM_EVENT_SWITCH);
             logDebugP("SwitchInside triggered");
             break;
         case DOR_KoSwitchOutside:
@@ -125,19 +107,19 @@ void DoorControllerModule::processInputKo(GroupObject &ko)
 
             // switch trigger can only be set, not reset externally
             switchOutsideTrigger = KoDOR_SwitchOutside.value(DPT_Switch) ? true : switchOutsideTrigger;
+            raiseChannels(FSM_EVENT_SWITCH);
             logDebugP("SwitchOutside triggered");
             break;
         case DOR_KoDoorLock:
-            lockRequested = KoDOR_DoorLock.value(DPT_Switch);
-            logDebugP("LockRequested: %d", lockRequested);
+            requestLock(KoDOR_DoorLock.value(DPT_Switch));
             break;
     }
 }
 
 uint16_t DoorControllerModule::flashSize()
 {
-    // Version + DoorMode
-    return 1 + 1;
+    // versioned TLV block with spare room for new fields, see DoorPersistence.h
+    return DOOR_FLASH_SIZE;
 }
 
 void DoorControllerModule::readFlash(const uint8_t *data, const uint16_t size)
@@ -145,43 +127,182 @@ void DoorControllerModule::readFlash(const uint8_t *data, const uint16_t size)
     if (size == 0) // first call - without data
         return;
 
-    byte version = openknx.flash.readByte();
-    if (version != 1) // version unknown
+    // migrate version 1: version + door mode
+    if (data[0] == 1 && size >= 2)
     {
-        logDebugP("Wrong version of flash data: version %d", version);
+        applyDoorMode(static_cast<DoorMode>(data[1]));
+        logDebugP("DoorMode read from flash (version 1): %d", doorMode);
         return;
     }
 
-    doorMode = static_cast<DoorMode>(openknx.flash.readByte());
+    DoorFlashReader reader(data, size);
+    if (!reader.valid())
+    {
+        logDebugP("Invalid flash data: version %d", data[0]);
+        return;
+    }
+
+    uint8_t mode = 0;
+    if (reader.read(FLASH_TAG_DOOR_MODE, mode))
+    {
+        applyDoorMode(static_cast<DoorMode>(mode));
+        logDebugP("DoorMode read from flash: %d", doorMode);
+    }
+
+    uint8_t direction = 0;
+    if (reader.read(FLASH_TAG_DOOR_DIRECTION, direction))
+        applyDoorDirection(direction == DoorDirection::ENTRY ? DoorDirection::ENTRY : DoorDirection::EXIT);
+
+    DoorCounters::Values counters = {};
+    if (reader.read(FLASH_TAG_COUNTERS, counters))
+        doorCounters.merge(counters);
+
+    // one set of estimates per channel, channels missing in the record start unlearned
+    DoorTiming::Estimate estimates[DOOR_CHANNEL_COUNT][DoorTiming::METRIC_COUNT] = {};
+    if (reader.read(FLASH_TAG_TIMING, estimates, sizeof(estimates)))
+    {
+        for (uint8_t i = 0; i < DOOR_CHANNEL_COUNT; i++)
+            memcpy(channels[i].timing().estimates(), estimates[i], sizeof(estimates[i]));
+        logDebugP("Learned drive timing read from flash");
+    }
+}
+
+void DoorControllerModule::writeFlash()
+{
+    DoorFlashWriter writer;
+    writer.add(FLASH_TAG_DOOR_MODE, (uint8_t)doorMode);
+    writer.add(FLASH_TAG_DOOR_DIRECTION, (uint8_t)doorDirectionAllowed);
+    writer.add(FLASH_TAG_COUNTERS, doorCounters.values());
+
+    DoorTiming::Estimate estimates[DOOR_CHANNEL_COUNT][DoorTiming::METRIC_COUNT];
+    static_assert(sizeof(estimates) <= 255, "Learned drive timing of all channels exceeds a flash record");
+    for (uint8_t i = 0; i < DOOR_CHANNEL_COUNT; i++)
+        memcpy(estimates[i], channels[i].timing().estimates(), sizeof(estimates[i]));
+    writer.add(FLASH_TAG_TIMING, estimates, sizeof(estimates));
+
+    // deterministic output, unchanged state results in identical bytes
+    const uint8_t *block = writer.finish();
+    for (uint16_t i = 0; i < DOOR_FLASH_SIZE; i++)
+        openknx.flash.writeByte(block[i]);
+}
+
+void DoorControllerModule::applyDoorMode(DoorMode mode)
+{
+    doorMode = mode;
     KoDOR_DoorMode.valueNoSend((byte)doorMode, DPT_DecimalFactor);
     KoDOR_DoorModeStatus.valueNoSend((byte)doorMode, DPT_DecimalFactor);
-    logDebugP("DoorMode read from flash: %d", doorMode);
+    if (doorMode == DoorMode::AIRLOCK)
+        warnRelayState("Airlock interlock");
+    raiseChannels(FSM_EVENT_MODE);
+    loopDirty |= DIRTY_OUTPUTS;
+    doorEvents.publish(DoorEvents::DOOR_MODE, doorMode);
 }
 
-void DoorControllerModule::writeFlash()
+void DoorControllerModule::warnRelayState(const char *use)
+{
+    // the contacts give no position feedback, see DoorRelay.h
+    if (doorRelay.enabled())
+        logInfoP("%s relies on the modelled door state of the contact interface", use);
+}
+
+void DoorControllerModule::applyDoorDirection(DoorDirection::Direction direction)
+{
+    doorDirectionAllowed = direction;
+    KoDOR_DoorDirection.valueNoSend((byte)doorDirectionAllowed, DPT_Value_1_Ucount);
+    raiseChannels(FSM_EVENT_MODE);
+}
+
+void DoorControllerModule::processDirection(bool inside, bool active, uint32_t changedAt)
+{
+    // the raw radars, independent of their routing; edge time from the ISR
+    // timestamp, both radars may be processed in the same loop
+    const uint32_t edge = millis() - (micros() - changedAt) / 1000;
+    const DoorDirection::Direction approach = doorDirection.radarChanged(inside, active, edge);
+    if (doorMode != DoorMode::DIRECTIONAL || !active)
+        return;
+
+    if (approach != DoorDirection::NONE && approach != doorDirectionAllowed)
+    {
+        doorDirection.skipped();
+        return;
+    }
+
+    // held back as the walk-through of the other side, a presence that stays opens after the window
+    if (approach == DoorDirection::NONE && (inside ? DoorDirection::EXIT : DoorDirection::ENTRY) == doorDirectionAllowed)
+        fsmDirectionTimer.start(edge, DOOR_DIRECTION_WINDOW);
+}
+
+void DoorControllerModule::publishSensor(SensorBit bit, bool active)
 {
-    openknx.flash.writeByte(1); // Version
-    openknx.flash.writeByte((byte)doorMode);
+    // the status KOs carry the value for bindings via KO, see eventKo()
+    switch (bit)
+    {
+        case SENSOR_BIT_INSIDE_RAD: KoDOR_PresenceInsideStatus.valueNoSend(active, DPT_Switch); break;
+        case SENSOR_BIT_INSIDE_AIR: KoDOR_InfraredInsideStatus.valueNoSend(active, DPT_Switch); break;
+        case SENSOR_BIT_OUTSIDE_RAD: KoDOR_PresenceOutsideStatus.valueNoSend(active, DPT_Switch); break;
+        case SENSOR_BIT_OUTSIDE_AIR: KoDOR_InfraredOutsideStatus.valueNoSend(active, DPT_Switch); break;
+        default: break;
+    }
+    doorEvents.publish(DoorEvents::SENSOR, active, bit);
+}
+
+GroupObject *DoorControllerModule::eventKo(const DoorEvents::Record &record)
+{
+    // a KO only holds the last value of a loop, the record the one at its time;
+    // records are dispatched in order, the last one leaves the KO as it was
+    GroupObject *ko = nullptr;
+    switch (record.event)
+    {
+        case DoorEvents::DOOR_STATE:
+            KoDOR_DoorStatus.valueNoSend(record.value, DPT_Switch_Control);
+            return &KoDOR_DoorStatus;
+        case DoorEvents::DOOR_MODE:
+            KoDOR_DoorModeStatus.valueNoSend(record.value, DPT_DecimalFactor);
+            return &KoDOR_DoorModeStatus;
+        case DoorEvents::LOCK:
+            KoDOR_DoorLockStatus.valueNoSend((bool)record.value, DPT_Switch);
+            return &KoDOR_DoorLockStatus;
+        case DoorEvents::SENSOR:
+            switch (record.data)
+            {
+                case SENSOR_BIT_INSIDE_RAD: ko = &KoDOR_PresenceInsideStatus; break;
+                case SENSOR_BIT_INSIDE_AIR: ko = &KoDOR_InfraredInsideStatus; break;
+                case SENSOR_BIT_OUTSIDE_RAD: ko = &KoDOR_PresenceOutsideStatus; break;
+                case SENSOR_BIT_OUTSIDE_AIR: ko = &KoDOR_InfraredOutsideStatus; break;
+                default: return nullptr;
+            }
+            ko->valueNoSend((bool)record.value, DPT_Switch);
+            return ko;
+        default: return nullptr;
+    }
 }
 
 void DoorControllerModule::interruptSensorInsideRadChange()
 {
     sensorInsideRadActiveNew = digitalRead(SENSOR_INSIDE_RAD_PIN) == SENSOR_RAD_ACTIVE;
+    sensorsChanged = true;
+    sensorInsideRadChangedAt = micros();
 }
 
 void DoorControllerModule::interruptSensorInsideAirChange()
 {
     sensorInsideAirActiveNew = digitalRead(SENSOR_INSIDE_AIR_PIN) == SENSOR_AIR_ACTIVE;
+    sensorsChanged = true;
+    sensorInsideAirChangedAt = micros();
 }
 
 void DoorControllerModule::interruptSensorOutsideRadChange()
 {
     sensorOutsideRadActiveNew = digitalRead(SENSOR_OUTSIDE_RAD_PIN) == SENSOR_RAD_ACTIVE;
+    sensorsChanged = true;
+    sensorOutsideRadChangedAt = micros();
 }
 
 void DoorControllerModule::interruptSensorOutsideAirChange()
 {
     sensorOutsideAirActiveNew = digitalRead(SENSOR_OUTSIDE_AIR_PIN) == SENSOR_AIR_ACTIVE;
+    sensorsChanged = true;
+    sensorOutsideAirChangedAt = micros();
 }
 
 void DoorControllerModule::enableExtInterface()
@@ -225,125 +346,227 @@ void DoorControllerModule::enableExtInterface()
 
 void DoorControllerModule::loop()
 {
-    processDoorSerial();
+#ifdef DOOR_PERF
+    const uint32_t loopStart = loopProfiler.now();
+#endif
 
-    processSensorInsideRadChange();
-    processSensorInsideAirChange();
-    processSensorOutsideRadChange();
-    processSensorOutsideAirChange();
-
-    processTestSignal();
-    checkProtection();
-    checkDoorPower();
-    updateDoorState();
-    processDoorStateMachine();
-    updateExtensionOutputs();
-}
+    // stages only run if one of their inputs changed, an idle loop only
+    // polls the UART and checks a few timers
+    if (sensorsChanged)
+    {
+        // cleared before reading, an edge during processing marks it again
+        sensorsChanged = false;
+        loopDirty |= DIRTY_SENSORS;
+    }
 
-void DoorControllerModule::doorMessageCallback(const std::vector<uint8_t>& payload)
-{
-    // Only output the received command if it differs from the last one we saw.
-    if (payload.size() == DOOR_PAYLOAD_SIZE)
+    if (delayCheckMillis(lastPoll, DOOR_POLL_INTERVAL))
     {
-        if (doorDebugOutput ||
-            memcmp(payload.data(), lastDataDoorReceived, DOOR_PAYLOAD_SIZE) != 0)
-        {
-            memcpy(lastDataDoorReceived, payload.data(), DOOR_PAYLOAD_SIZE);
-            logDebugP("Door RECEIVED command changed:");
-            logIndentUp();
-            logHexDebugP(lastDataDoorReceived, DOOR_PAYLOAD_SIZE);
-            logIndentDown();
+        lastPoll = delayTimerInit();
+        loopDirty |= DIRTY_POLL | DIRTY_OUTPUTS;
+    }
 
-            switch (lastDataDoorReceived[DOOR_PAYLOAD_SIZE - 1])
-            {
-                case DOOR_STATE_OPEN:
-                    doorState = DoorState::OPEN;
-                    break;
-
-                case DOOR_STATE_CLOSED:
-                    doorState = DoorState::CLOSED;
-                    break;
-
-                case DOOR_STATE_CLOSING:
-                    doorState = DoorState::CLOSING;
-                    break;
-
-                case DOOR_STATE_OPENING:
-                    doorState = DoorState::OPENING;
-                    break;
-                
-                default:
-                    logInfoP("Unknown door state received: %02X", lastDataDoorReceived[DOOR_PAYLOAD_SIZE - 1]);
-                    break;
-            }
-        }
+    DOOR_PERF_MEASURE(STAGE_DOOR_SERIAL, processDoorSerial());
 
-        nextMessageReceived = true;
-    }
-    else
+    if (takeDirty(DIRTY_SENSORS))
     {
-        // Different length -> treat as changed: store what we can and print payload
-        size_t copyLen = std::min(payload.size(), DOOR_PAYLOAD_SIZE);
-        memset(lastDataDoorReceived, 0, DOOR_PAYLOAD_SIZE);
-        if (copyLen > 0)
-            memcpy(lastDataDoorReceived, payload.data(), copyLen);
+        // test responses are evaluated before they could count as detections
+        DOOR_PERF_MEASURE(STAGE_TEST_SIGNAL, processTestSignal());
+        DOOR_PERF_MEASURE(STAGE_SENSOR_INSIDE_RAD, processSensorInsideRadChange());
+        DOOR_PERF_MEASURE(STAGE_SENSOR_INSIDE_AIR, processSensorInsideAirChange());
+        DOOR_PERF_MEASURE(STAGE_SENSOR_OUTSIDE_RAD, processSensorOutsideRadChange());
+        DOOR_PERF_MEASURE(STAGE_SENSOR_OUTSIDE_AIR, processSensorOutsideAirChange());
+        DOOR_PERF_MEASURE(STAGE_PROTECTION, checkProtection());
+        loopDirty |= DIRTY_OUTPUTS;
+    }
 
-        logDebugP("Door RECEIVED command (len %u) differs from stored one:", static_cast<unsigned>(payload.size()));
-        if (!payload.empty())
-        {
-            logIndentUp();
-            logHexDebugP(payload.data(), payload.size());
-            logIndentDown();
-        }
+    if (takeDirty(DIRTY_POLL))
+    {
+        DOOR_PERF_MEASURE(STAGE_TEST_SIGNAL, processTestSignal());
+        DOOR_PERF_MEASURE(STAGE_DOOR_POWER, checkDoorPower());
     }
+
+    if (takeDirty(DIRTY_DOOR_STATE))
+        DOOR_PERF_MEASURE(STAGE_DOOR_STATE, updateDoorState());
+
+    // before the state machine, a locked door must not open on a trigger of the same loop
+    DOOR_PERF_MEASURE(STAGE_LOCK, processLock());
+    DOOR_PERF_MEASURE(STAGE_STATE_MACHINE, processDoorStateMachine());
+
+    if (takeDirty(DIRTY_OUTPUTS))
+        DOOR_PERF_MEASURE(STAGE_EXT_OUTPUTS, updateExtensionOutputs());
+
+    // manual protocol exploration, see DoorScript.h
+    const DoorCommandDefinition *scripted = doorScript.loop();
+    if (scripted != nullptr)
+        sendDoorCommand(*scripted);
+
+    DOOR_PERF_MEASURE(STAGE_HISTORY, doorHistory.loop());
+    DOOR_PERF_MEASURE(STAGE_COUNTERS, updateCounters(doorCounters.loop()));
+    // last, subscribers see the state of this loop iteration
+    DOOR_PERF_MEASURE(STAGE_EVENTS, doorEvents.dispatch());
+
+#ifdef DOOR_PERF
+    loopProfiler.record(STAGE_LOOP_TOTAL, loopProfiler.now() - loopStart);
+#endif
 }
 
-void DoorControllerModule::processDoorSerial()
+void DoorControllerModule::raiseChannels(uint8_t events)
+{
+    for (DoorChannel &channel : channels)
+        channel.raise(events);
+}
+
+void DoorControllerModule::raiseSensorEvent(uint32_t changedAt)
 {
-    doorSerial.poll();
+    // the trigger of a latency trace, see DoorChannel::sendMainMld()
+    sensorEventAt = changedAt;
+    raiseChannels(FSM_EVENT_SENSOR);
+}
+
+bool DoorControllerModule::openAllowed(uint8_t channel)
+{
+    // events are dispatched lowest bit first, a trigger is seen before FSM_EVENT_LOCK
+    if (lockActive)
+        return false;
+
+    if (doorMode != DoorMode::AIRLOCK)
+        return true;
+
+    DoorAirlockChannel airlock[DOOR_CHANNEL_COUNT];
+    airlockChannels(airlock);
+    return doorAirlockOpenAllowed(airlock, channel);
+}
+
+bool DoorControllerModule::airlockWaiting(uint8_t channel)
+{
+    if (doorMode != DoorMode::AIRLOCK)
+        return false;
 
-    bool timeout = lastDoorSent > 0 && delayCheckMillis(lastDoorSent, DOOR_SEND_TIMEOUT);
-    if (doorDataSendingHasData && (startSending || nextMessageReceived || timeout))
+    DoorAirlockChannel airlock[DOOR_CHANNEL_COUNT];
+    airlockChannels(airlock);
+    return doorAirlockWaiting(airlock, channel);
+}
+
+void DoorControllerModule::airlockChannels(DoorAirlockChannel (&airlock)[DOOR_CHANNEL_COUNT])
+{
+    for (DoorChannel &channel : channels)
     {
-        if (timeout)
-            logDebugP("Door SEND timeout occurred");
-        
-        const uint8_t *payloadToSend = doorDataSending;
+        airlock[channel.index()] = {
+            channel.state() == DoorState::CLOSED,
+            channel.machineState() == DoorChannel::STATE_TRANSITION,
+            channel.machineState() == DoorChannel::STATE_OPEN,
+            radarActive(channel.index())};
+    }
+}
 
-        if (activeDoorPrefixes != nullptr && activeDoorPrefixIndex < activeDoorPrefixCount)
-        {
-            payloadToSend = activeDoorPrefixes[activeDoorPrefixIndex];
-            ++activeDoorPrefixIndex;
-        }
+// In airlock mode the outer door (channel 0) only reacts to the outside
+// sensors and the inner door(s) to the inside sensors. Sensors on both sides
+// of a door can be wired in parallel to one input.
+uint8_t DoorControllerModule::sensorSide(uint8_t channel)
+{
+    if (doorMode != DoorMode::AIRLOCK || DOOR_CHANNEL_COUNT == 1)
+        return SENSOR_BITS_ALL;
 
-        doorSerial.sendPayload(payloadToSend, DOOR_PAYLOAD_SIZE);
-        lastDoorSent = delayTimerInit();
+    return channel == 0 ? SENSOR_BITS_OUTSIDE : SENSOR_BITS_INSIDE;
+}
 
-        if (doorDebugOutput ||
-            memcmp(payloadToSend, lastDataDoorSent, DOOR_PAYLOAD_SIZE) != 0)
-        {
-            memcpy(lastDataDoorSent, payloadToSend, DOOR_PAYLOAD_SIZE);
+// sensors routed to "Öffnen", the radars by default
+bool DoorControllerModule::radarActive(uint8_t channel)
+{
+    return sensorWord & sensorRoutes[ROUTE_OPEN] & sensorSide(channel);
+}
 
-            logDebugP("Door SEND command changed:");
-            logIndentUp();
-            logHexDebugP(lastDataDoorSent, DOOR_PAYLOAD_SIZE);
-            logIndentDown();
-        }
+bool DoorControllerModule::airActive(uint8_t channel)
+{
+    return sensorWord & SENSOR_BITS_AIR & sensorSide(channel);
+}
+
+uint8_t DoorControllerModule::sensorTestSensors()
+{
+    // only the AIR sensors have a test input
+    const uint8_t safety = sensorRoutes[ROUTE_HSK] | sensorRoutes[ROUTE_NSK];
+    return (safety & SENSOR_BIT_INSIDE_AIR ? 1 << DoorSensorTest::INSIDE : 0) |
+           (safety & SENSOR_BIT_OUTSIDE_AIR ? 1 << DoorSensorTest::OUTSIDE : 0);
+}
+
+DoorControllerModule::DoorState DoorControllerModule::combinedDoorState()
+{
+    // moving if any channel moves, open or closed only if all channels agree
+    bool opening = false;
+    bool closing = false;
+    bool equal = true;
+    for (DoorChannel &channel : channels)
+    {
+        opening = opening || channel.state() == DoorState::OPENING;
+        closing = closing || channel.state() == DoorState::CLOSING;
+        equal = equal && channel.state() == channels[0].state();
+    }
+
+    if (opening)
+        return DoorState::OPENING;
+    if (closing)
+        return DoorState::CLOSING;
+    if (equal)
+        return channels[0].state();
+    return DoorState::UNDEFINED;
+}
+
+void DoorControllerModule::sendDoorCommand(const DoorCommandDefinition &definition)
+{
+    for (DoorChannel &channel : channels)
+        channel.setDoorCommand(definition);
+}
 
-        startSending = false;
-        nextMessageReceived = false;
+bool DoorControllerModule::prefixesPending(const uint8_t *const *prefixes)
+{
+    for (DoorChannel &channel : channels)
+    {
+        if (channel.prefixesPending(prefixes))
+            return true;
     }
+    return false;
+}
+
+uint32_t DoorControllerModule::linkErrorCount()
+{
+    uint32_t errors = 0;
+    for (DoorChannel &channel : channels)
+        errors += channel.serial().getLinkErrorCount();
+    return errors;
+}
+
+void DoorControllerModule::processDoorSerial()
+{
+    for (DoorChannel &channel : channels)
+        channel.processDoorSerial();
+
+    publishLinkStats();
+}
+
+void DoorControllerModule::publishLinkStats()
+{
+    if (!openknx.afterStartupDelay() || !delayCheckMillis(lastLinkStatsSent, DOOR_LINK_STATS_INTERVAL))
+        return;
 
-    // uint8_t payload[DoorSerial::MaxMessageLength];
+    KoDOR_LinkErrors.value(linkErrorCount(), DPT_Value_4_Ucount);
+    lastLinkStatsSent = delayTimerInit();
+}
 
-    // while (doorSerial.hasData())
-    // {
-    //     if (doorSerial.readBinaryData(payload, sizeof(payload)) == 0)
-    //     {
-    //         break;
-    //     }
-    //     // TODO: interpret door payload
-    // }
+void DoorControllerModule::updateCounters(bool send)
+{
+    const DoorCounters::Values &counters = doorCounters.values();
+    if (send && openknx.afterStartupDelay())
+    {
+        KoDOR_DoorCycles.value(counters.cycles, DPT_Value_4_Ucount);
+        KoDOR_MotorRuntime.value(counters.runtime, DPT_Value_4_Ucount);
+        KoDOR_LockActuations.value(counters.lockActuations, DPT_Value_4_Ucount);
+    }
+    else
+    {
+        KoDOR_DoorCycles.valueNoSend(counters.cycles, DPT_Value_4_Ucount);
+        KoDOR_MotorRuntime.valueNoSend(counters.runtime, DPT_Value_4_Ucount);
+        KoDOR_LockActuations.valueNoSend(counters.lockActuations, DPT_Value_4_Ucount);
+    }
 }
 
 void DoorControllerModule::processSensorInsideRadChange()
@@ -351,15 +574,37 @@ void DoorControllerModule::processSensorInsideRadChange()
     if (sensorInsideRadActive != sensorInsideRadActiveNew)
     {
         sensorInsideRadActive = sensorInsideRadActiveNew;
+        updateSensorWord(SENSOR_BIT_INSIDE_RAD, sensorInsideRadActive);
+        if (sensorInsideRadActive)
+        {
+            // a pass-by radar has to stay active for the confirm delay
+            fsmPredictorTimer.start(millis(), DOOR_PREDICTOR_CONFIRM_DELAY);
+            doorTraffic.trigger(millis());
+            doorHistory.add(DoorHistory::Event::SENSOR, 0);
+        }
+        processDirection(true, sensorInsideRadActive, sensorInsideRadChangedAt);
+        publishSensor(SENSOR_BIT_INSIDE_RAD, sensorInsideRadActive);
+        // the predictor only learns from radars that open the door
+        doorPredictor.radarChanged(DoorPredictor::RADAR_INSIDE, sensorInsideRadActive && (sensorRoutes[ROUTE_OPEN] & SENSOR_BIT_INSIDE_RAD), millis());
+        raiseSensorEvent(sensorInsideRadChangedAt);
         logDebugP("sensorInsideRadActive: %i", sensorInsideRadActive);
     }
 }
 
 void DoorControllerModule::processSensorInsideAirChange()
 {
+    // a test response, taken over when the cycle has finished
+    if (doorSensorTest.running())
+        return;
+
     if (sensorInsideAirActive != sensorInsideAirActiveNew)
     {
         sensorInsideAirActive = sensorInsideAirActiveNew;
+        updateSensorWord(SENSOR_BIT_INSIDE_AIR, sensorInsideAirActive);
+        publishSensor(SENSOR_BIT_INSIDE_AIR, sensorInsideAirActive);
+        if (sensorInsideAirActive)
+            doorPredictor.airActive();
+        raiseSensorEvent(sensorInsideAirChangedAt);
         logDebugP("sensorInsideAirActive: %i", sensorInsideAirActive);
     }
 }
@@ -369,76 +614,79 @@ void DoorControllerModule::processSensorOutsideRadChange()
     if (sensorOutsideRadActive != sensorOutsideRadActiveNew)
     {
         sensorOutsideRadActive = sensorOutsideRadActiveNew;
+        updateSensorWord(SENSOR_BIT_OUTSIDE_RAD, sensorOutsideRadActive);
+        if (sensorOutsideRadActive)
+        {
+            // a pass-by radar has to stay active for the confirm delay
+            fsmPredictorTimer.start(millis(), DOOR_PREDICTOR_CONFIRM_DELAY);
+            doorTraffic.trigger(millis());
+            doorHistory.add(DoorHistory::Event::SENSOR, 1);
+        }
+        processDirection(false, sensorOutsideRadActive, sensorOutsideRadChangedAt);
+        publishSensor(SENSOR_BIT_OUTSIDE_RAD, sensorOutsideRadActive);
+        doorPredictor.radarChanged(DoorPredictor::RADAR_OUTSIDE, sensorOutsideRadActive && (sensorRoutes[ROUTE_OPEN] & SENSOR_BIT_OUTSIDE_RAD), millis());
+        raiseSensorEvent(sensorOutsideRadChangedAt);
         logDebugP("sensorOutsideRadActive: %i", sensorOutsideRadActive);
     }
 }
 
 void DoorControllerModule::processSensorOutsideAirChange()
 {
+    // a test response, taken over when the cycle has finished
+    if (doorSensorTest.running())
+        return;
+
     if (sensorOutsideAirActive != sensorOutsideAirActiveNew)
     {
         sensorOutsideAirActive = sensorOutsideAirActiveNew;
+        updateSensorWord(SENSOR_BIT_OUTSIDE_AIR, sensorOutsideAirActive);
+        publishSensor(SENSOR_BIT_OUTSIDE_AIR, sensorOutsideAirActive);
+        if (sensorOutsideAirActive)
+            doorPredictor.airActive();
+        raiseSensorEvent(sensorOutsideAirChangedAt);
         logDebugP("sensorOutsideAirActive: %i", sensorOutsideAirActive);
     }
 }
 
 void DoorControllerModule::processTestSignal()
 {
-    // int testSignal = analogRead(MAIN_TST_PIN);
-    // if (testSignal > MAIN_TST_THRESHOLD + MAIN_TST_THRESHOLD_MARGIN)
-    // {
-    //     if (mainTstActive)
-    //     {
-    //         digitalWrite(SENSOR_TST_PIN, !SENSOR_TST_ACTIVE);
-    //         sensorTstActive = false;
-    //         mainTstActive = false;
-
-    //         logDebugP("mainTstActive: %i", mainTstActive);
-    //     }
-    // }
-    // else if (testSignal < MAIN_TST_THRESHOLD - MAIN_TST_THRESHOLD_MARGIN)
-    // {
-    //     if (!mainTstActive)
-    //     {
-    //         digitalWrite(SENSOR_TST_PIN, SENSOR_TST_ACTIVE);
-    //         sensorTstActive = true;
-    //         mainTstActive = true;
-
-    //         logDebugP("mainTstActive: %i", mainTstActive);
-    //     }
-    // }
+    // the cycle masks the closing edge sensors, not while a leaf closes
+    if (!doorSensorTest.running() && doorState == DoorState::CLOSING)
+        return;
+
+    const bool active[DoorSensorTest::SENSOR_COUNT] = {sensorInsideAirActiveNew, sensorOutsideAirActiveNew};
+    const uint32_t changedAt[DoorSensorTest::SENSOR_COUNT] = {sensorInsideAirChangedAt, sensorOutsideAirChangedAt};
+    const bool wasRunning = doorSensorTest.running();
+    if (!doorSensorTest.loop(micros(), active, changedAt))
+        return;
+
+    // EXT_MAIN_TST_PIN shows the whole cycle, test input active and released
+    mainTstActive = doorSensorTest.running();
+    loopDirty |= DIRTY_OUTPUTS;
+    if (wasRunning && !doorSensorTest.running())
+    {
+        // take over the sensor states masked during the cycle, closing may be allowed now
+        loopDirty |= DIRTY_SENSORS;
+        raiseSensorEvent(micros());
+    }
 }
 
 void DoorControllerModule::checkProtection()
 {
-    bool mainHskActiveNew = false;
-    if (ParamDOR_SafetySensorHsk == 1)
-        mainHskActiveNew = sensorInsideAirActive;
-    else if (ParamDOR_SafetySensorHsk == 2)
-        mainHskActiveNew = sensorOutsideAirActive;
-    else if (ParamDOR_SafetySensorHsk == 3)
-        mainHskActiveNew = sensorInsideAirActive || sensorOutsideAirActive;
-
+    const bool mainHskActiveNew = sensorWord & sensorRoutes[ROUTE_HSK];
     if (mainHskActive != mainHskActiveNew)
     {
         mainHskActive = mainHskActiveNew;
-        //digitalWrite(MAIN_HSK_PIN, mainHskActive ? MAIN_HSK_NSK_ACTIVE : !MAIN_HSK_NSK_ACTIVE);
+        doorRelay.set(DoorRelay::HSK, mainHskActive);
 
         logDebugP("mainHskActive: %i", mainHskActive);
     }
 
-    bool mainNskActiveNew = false;
-    if (ParamDOR_SafetySensorNsk == 1)
-        mainNskActiveNew = sensorInsideAirActive;
-    else if (ParamDOR_SafetySensorNsk == 2)
-        mainNskActiveNew = sensorOutsideAirActive;
-    else if (ParamDOR_SafetySensorNsk == 3)
-        mainNskActiveNew = sensorInsideAirActive || sensorOutsideAirActive;
-
+    const bool mainNskActiveNew = sensorWord & sensorRoutes[ROUTE_NSK];
     if (mainNskActive != mainNskActiveNew)
     {
         mainNskActive = mainNskActiveNew;
-        //digitalWrite(MAIN_NSK_PIN, mainNskActive ? MAIN_HSK_NSK_ACTIVE : !MAIN_HSK_NSK_ACTIVE);
+        doorRelay.set(DoorRelay::NSK, mainNskActive);
 
         logDebugP("mainNskActive: %i", mainNskActive);
     }
@@ -469,10 +717,27 @@ void DoorControllerModule::updateDoorState()
 {
     //###ToDo
 
+    bool changed = false;
+    for (DoorChannel &channel : channels)
+        changed = channel.updateDoorState() || changed;
+
+    if (!changed)
+        return;
+
+    // a waiting channel may open now (airlock)
+    if (DOOR_CHANNEL_COUNT > 1)
+        raiseChannels(FSM_EVENT_INTERLOCK);
+    updateDriveDegraded();
+
+    doorState = combinedDoorState();
     if (doorStatePrevious != doorState)
     {
+        // the status KO keeps the last defined state, subscribers get what the KO holds
         if (doorState != DoorState::UNDEFINED)
+        {
             KoDOR_DoorStatus.valueNoSend((byte)doorState, DPT_Switch_Control);
+            doorEvents.publish(DoorEvents::DOOR_STATE, doorState);
+        }
 
         switch (doorState)
         {
@@ -500,8 +765,7 @@ void DoorControllerModule::updateDoorState()
         }
 
         doorStatePrevious = doorState;
-        doorStateChanged = true;
-        doorStateLastChanged = millis();
+        loopDirty |= DIRTY_OUTPUTS;
     }
 
     /*logDebugP("doorOpen: %d", doorOpen);
@@ -511,185 +775,82 @@ void DoorControllerModule::updateDoorState()
 
 void DoorControllerModule::processDoorStateMachine()
 {
+    // the state machine only runs in automatic and manual mode, FSM_EVENT_MODE
+    // re-evaluates everything that was missed in the meantime
     if (doorMode != DoorMode::AUTOMATIC &&
+        doorMode != DoorMode::AIRLOCK &&
+        doorMode != DoorMode::DIRECTIONAL &&
         doorMode != DoorMode::MANUAL)
+    {
+        for (DoorChannel &channel : channels)
+            channel.discardEvents();
         return;
-
-    // if (mainLckStart > 0)
-    // {
-    //     if ((millis() - mainLckStart >= MAIN_SIGNAL_LENGTH))
-    //     {
-    //         digitalWrite(MAIN_LCK_PIN, !MAIN_LCK_ACTIVE);
-    //         mainLckActive = false;
-    //         mainLckStart = 0;
-
-    //         logDebugP("mainLckActive: %i", mainLckActive);
-    //     }
-    // }
-
-    // if (mainMdlStart > 0)
-    // {
-    //     if ((millis() - mainMdlStart >= MAIN_SIGNAL_LENGTH))
-    //         sendMainMld(false);
-    // }
-    // else if (lockRequested != lockActive)
-    // {
-    //     if (doorStateMachine == DoorStateMachine::STATE_CLOSED ||
-    //         doorStateMachine == DoorStateMachine::STATE_CLOSED_LOCKED)
-    //     {
-    //         lock(lockRequested);
-    //     }
-    //     else if (millis() - lastLockRequestMld >= LOCK_REQUEST_MLD_TIMEOUT)
-    //     {
-    //         sendMainMld(true);
-    //         lastLockRequestMld = millis();
-    //     }
-    // }
-
-    bool triggerMld = false;
-    switch (doorStateMachine)
-    {
-        case DoorStateMachine::STATE_UNDEFINED:
-            if (doorState == DoorState::OPEN)
-                doorStateMachine = DoorStateMachine::STATE_OPEN_START;
-            else if (doorState == DoorState::CLOSED)
-                doorStateMachine = DoorStateMachine::STATE_CLOSED;
-            break;
-
-        case DoorStateMachine::STATE_OPEN_START:
-            doorOpenSince = millis();
-            doorStateMachine = DoorStateMachine::STATE_OPEN;
-            break;
-
-        case DoorStateMachine::STATE_OPEN:
-            if (doorState != DoorState::OPEN)
-            {
-                doorStateMachine = DoorStateMachine::STATE_UNDEFINED;
-                break;
-            }
-
-            if (doorMode == DoorMode::AUTOMATIC)
-            {
-                triggerMld =
-                    !sensorInsideRadActive && !sensorOutsideRadActive &&
-                    !sensorInsideAirActive && !sensorOutsideAirActive &&
-                    (millis() - doorOpenSince >= DOOR_OPEN_MIN);
-            }
-            else
-            {
-                triggerMld =
-                    !sensorInsideAirActive && !sensorOutsideAirActive &&
-                    (switchInsideTrigger || switchOutsideTrigger);
-            }
-
-            if (triggerMld)
-            {
-                sendMainMld(true);
-                doorStateMachine = DoorStateMachine::STATE_TRANSITION;
-            }
-
-            break;
-
-        case DoorStateMachine::STATE_CLOSED:
-            if (doorState != DoorState::CLOSED)
-            {
-                doorStateMachine = DoorStateMachine::STATE_UNDEFINED;
-                break;
-            }
-
-            if (lockActive)
-            {
-                doorStateMachine = DoorStateMachine::STATE_CLOSED_LOCKED;
-                break;
-            }
-
-            if (doorMode == DoorMode::AUTOMATIC)
-                triggerMld = sensorInsideRadActive || sensorOutsideRadActive;
-            else
-                triggerMld = switchInsideTrigger || switchOutsideTrigger;
-
-            if (triggerMld)
-            {
-                sendMainMld(true);
-                doorStateMachine = DoorStateMachine::STATE_TRANSITION;
-            }
-
-            break;
-
-        case DoorStateMachine::STATE_CLOSED_LOCKED:
-            // this should not be possible, but just in case to avoid getting stuck
-            if (doorState != DoorState::CLOSED)
-            {
-                doorStateMachine = DoorStateMachine::STATE_UNDEFINED;
-                break;
-            }
-
-            if (!lockActive)
-                doorStateMachine = DoorStateMachine::STATE_CLOSED;
-            break;
-
-        case DoorStateMachine::STATE_TRANSITION:
-            if (doorStateChanged ||
-                (millis() - doorStateLastChanged >= DOOR_STATE_CHANGED_TIMEOUT))
-            {
-                if (doorState == DoorState::OPEN)
-                    doorStateMachine = DoorStateMachine::STATE_OPEN_START;
-                else if (doorState == DoorState::CLOSED)
-                    doorStateMachine = DoorStateMachine::STATE_CLOSED;
-            }
-            break;
     }
 
-    if (doorStateMachinePrevious != doorStateMachine)
-    {
-        switch (doorStateMachine)
-        {
-            case DoorStateMachine::STATE_UNDEFINED:
-                logDebugP("DoorStateMachine: STATE_UNDEFINED");
-                break;
+    const uint32_t now = millis();
+    if (fsmPredictorTimer.expired(now))
+        raiseChannels(FSM_EVENT_TIMER);
+    if (fsmDirectionTimer.expired(now))
+        raiseSensorEvent(micros());
 
-            case DoorStateMachine::STATE_OPEN_START:
-                logDebugP("DoorStateMachine: STATE_OPEN_START");
-                break;
+    // the sensors that hold the door open under the fixed policy, see DoorTraffic.h
+    doorTraffic.held(radarActive(0) || airActive(0), now);
+    for (DoorChannel &channel : channels)
+        channel.processDoorStateMachine(now);
 
-            case DoorStateMachine::STATE_OPEN:
-                logDebugP("DoorStateMachine: STATE_OPEN");
-                break;
-
-            case DoorStateMachine::STATE_CLOSED:
-                logDebugP("DoorStateMachine: STATE_CLOSED");
-                break;
-
-            case DoorStateMachine::STATE_CLOSED_LOCKED:
-                logDebugP("DoorStateMachine: STATE_CLOSED_LOCKED");
-                break;
-
-            case DoorStateMachine::STATE_TRANSITION:
-                logDebugP("DoorStateMachine: STATE_TRANSITION");
-                break;
-        }
-
-        doorStateMachinePrevious = doorStateMachine;
+    // a switch trigger is meant for all channels, clear it once all have seen it
+    if (switchTriggerUsed)
+    {
+        switchInsideTrigger = false;
+        switchOutsideTrigger = false;
+        switchTriggerUsed = false;
     }
 }
 
-void DoorControllerModule::sendMainMld(bool active)
+void DoorControllerModule::updateDriveDegraded()
 {
-    // #ToDo
-    if (!active)
+    bool degraded = false;
+    for (DoorChannel &channel : channels)
+        degraded = degraded || channel.timing().degraded();
+    if (doorTimingDegraded == degraded)
         return;
 
-    doorStateChanged = false;
-    doorStateLastChanged = millis();
+    doorTimingDegraded = degraded;
+    KoDOR_DriveDegraded.value(degraded, DPT_Alarm);
+    logInfoP("Drive degraded: %i", degraded);
+}
 
-    if (doorState == DoorState::OPEN || doorState == DoorState::OPENING)
-        setDoorCommand(COMMAND_CLOSING);
-    else
-        setDoorCommand(COMMAND_OPENING);
+void DoorControllerModule::requestLock(bool active)
+{
+    loopDirty |= DIRTY_OUTPUTS;
+    logDebugP("LockRequested: %d", active);
+    if (active)
+        warnRelayState("Lock verification");
+    applyLockActions(doorLock.request(active, millis()));
+}
 
-    // digitalWrite(MAIN_MLD_PIN, active ? MAIN_MLD_ACTIVE : !MAIN_MLD_ACTIVE);
-    // mainMldActive = active;
-    // mainMdlStart = active ? millis() : 0;
+void DoorControllerModule::processLock()
+{
+    applyLockActions(doorLock.loop(doorState == DoorState::CLOSED, millis()));
+}
+
+void DoorControllerModule::applyLockActions(uint8_t actions)
+{
+    if (actions & DoorLock::ACTION_RELEASE)
+        lock(false);
+    if (actions & DoorLock::ACTION_ENGAGE)
+        lock(true);
+    // the leaves close through their state machine (guardLockClose)
+    if (actions & DoorLock::ACTION_CLOSE)
+        raiseChannels(FSM_EVENT_LOCK);
+    if (actions & DoorLock::ACTION_STATUS)
+        setLockStatus(doorLock.locked());
+}
+
+void DoorControllerModule::setLockStatus(bool locked)
+{
+    KoDOR_DoorLockStatus.valueNoSend(locked, DPT_Switch);
+    doorEvents.publish(DoorEvents::LOCK, locked, doorLock.step());
 }
 
 void DoorControllerModule::lock(bool active)
@@ -698,8 +859,13 @@ void DoorControllerModule::lock(bool active)
         return;
 
     digitalWrite(LOCK_PIN, active ? LOCK_ACTIVE : !LOCK_ACTIVE);
-    KoDOR_DoorLockStatus.valueNoSend(active, DPT_Switch);
+    doorRelay.pulse(DoorRelay::LCK);
     lockActive = active;
+    doorHistory.add(DoorHistory::Event::LOCK, lockActive);
+    if (lockActive)
+        doorCounters.addLockActuation();
+    raiseChannels(FSM_EVENT_LOCK);
+    loopDirty |= DIRTY_OUTPUTS;
 
     logDebugP("lockActive: %i", lockActive);
 }
@@ -712,6 +878,8 @@ void DoorControllerModule::updateExtensionOutputs()
         lastExtMainPwr = mainPwrActive;
     }
 
+    // impulses end in the timer interrupt, DIRTY_POLL refreshes the outputs
+    const bool mainMldActive = doorRelay.active(DoorRelay::MLD);
     if (lastExtMainMld != mainMldActive)
     {
         openknx.gpio.digitalWrite(EXT_MAIN_MLD_PIN, mainMldActive ? HIGH : LOW);
@@ -748,6 +916,7 @@ void DoorControllerModule::updateExtensionOutputs()
         lastExtMainTst = mainTstActive;
     }
 
+    const bool mainLckActive = doorRelay.active(DoorRelay::LCK);
     if (lastExtMainLck != mainLckActive)
     {
         openknx.gpio.digitalWrite(EXT_MAIN_LCK_PIN, mainLckActive ? HIGH : LOW);
@@ -780,11 +949,11 @@ void DoorControllerModule::updateExtensionOutputs()
         lastExtSensorInsideAir = sensorInsideAirActive;
     }
 
-    if (lastExtSensorTst != sensorTstActive)
+    if (lastExtSensorTst != doorSensorTest.testActive())
     {
-        openknx.gpio.digitalWrite(EXT_SENSOR_OUTSIDE_TST_PIN, sensorTstActive ? HIGH : LOW);
-        openknx.gpio.digitalWrite(EXT_SENSOR_INSIDE_TST_PIN, sensorTstActive ? HIGH : LOW);
-        lastExtSensorTst = sensorTstActive;
+        lastExtSensorTst = doorSensorTest.testActive();
+        openknx.gpio.digitalWrite(EXT_SENSOR_OUTSIDE_TST_PIN, lastExtSensorTst ? HIGH : LOW);
+        openknx.gpio.digitalWrite(EXT_SENSOR_INSIDE_TST_PIN, lastExtSensorTst ? HIGH : LOW);
     }
 
     if (lastExtSensorOutsideRad != sensorOutsideRadActive)
@@ -801,17 +970,17 @@ void DoorControllerModule::updateExtensionOutputs()
     
     if (lastExtDoorMode != doorMode)
     {
-        openknx.gpio.digitalWrite(EXT_DOOR_MODE_AUT_PIN, doorMode == DoorMode::AUTOMATIC ? HIGH : LOW);
+        openknx.gpio.digitalWrite(EXT_DOOR_MODE_AUT_PIN, doorMode == DoorMode::AUTOMATIC || doorMode == DoorMode::AIRLOCK || doorMode == DoorMode::DIRECTIONAL ? HIGH : LOW);
         openknx.gpio.digitalWrite(EXT_DOOR_MODE_MAN_PIN, doorMode == DoorMode::MANUAL ? HIGH : LOW);
         openknx.gpio.digitalWrite(EXT_DOOR_MODE_OPN_PIN, doorMode == DoorMode::ALWAYS_OPEN ? HIGH : LOW);
         openknx.gpio.digitalWrite(EXT_DOOR_MODE_CLD_PIN, doorMode == DoorMode::ALWAYS_CLOSED ? HIGH : LOW);
         lastExtDoorMode = doorMode;
     }
 
-    if (lastExtLockRqt != lockRequested)
+    if (lastExtLockRqt != doorLock.requested())
     {
-        openknx.gpio.digitalWrite(EXT_LOCK_RQT_PIN, lockRequested ? HIGH : LOW);
-        lastExtLockRqt = lockRequested;
+        openknx.gpio.digitalWrite(EXT_LOCK_RQT_PIN, doorLock.requested() ? HIGH : LOW);
+        lastExtLockRqt = doorLock.requested();
     }
 
     if (lastExtLockAct != lockActive)
@@ -835,85 +1004,394 @@ void DoorControllerModule::updateExtensionOutputs()
     }
 }
 
+// Console commands, see DoorConsole.h. The longest matching name wins, so
+// "dc status reset" and "dc status" can coexist.
+constexpr DoorConsoleCommand<DoorControllerModule> DoorControllerModule::CONSOLE_COMMANDS[] = {
+    {"dc send", "<it1/it2/it3/opg/opn/clg/cls/name/hex>", "Send built-in command, defined sequence or raw payload to door.", &DoorControllerModule::cmdSend},
+    {"dc def", "<name> [<hex> ...]", "Define sequence: prefixes sent once, then last payload. Without payload: delete.", &DoorControllerModule::cmdDefine},
+    {"dc seq", nullptr, "Print defined sequences.", &DoorControllerModule::cmdSequences},
+    {"dc script", "<path>", "Run door script from LittleFS (lines: <wait ms> <command> or def ...).", &DoorControllerModule::cmdScript},
+    {"dc script stop", nullptr, "Stop running door script.", &DoorControllerModule::cmdScriptStop},
+    {"dc commands", nullptr, "Print door command table.", &DoorControllerModule::cmdCommands},
+    {"dc commands load", nullptr, "Load door command table (" DOOR_COMMAND_TABLE_PATH ").", &DoorControllerModule::cmdCommandsLoad},
+    {"dc commands reset", nullptr, "Use built-in door commands.", &DoorControllerModule::cmdCommandsReset},
+    {"dc relay", nullptr, "Print contact interface status.", &DoorControllerModule::cmdRelay},
+    {"dc sensors", nullptr, "Print sensor inputs and their routing.", &DoorControllerModule::cmdSensors},
+    {"dc sensortest", nullptr, "Print sensor test status and response times.", &DoorControllerModule::cmdSensorTest},
+    {"dc sensortest run", nullptr, "Test the safety sensors now.", &DoorControllerModule::cmdSensorTestRun},
+    {"dc sensortest reset", nullptr, "Reset sensor response time statistics.", &DoorControllerModule::cmdSensorTestReset},
+    {"dc status", nullptr, "Print door serial status and link statistics.", &DoorControllerModule::cmdStatus},
+    {"dc status reset", nullptr, "Reset door link statistics.", &DoorControllerModule::cmdStatusReset},
+    {"dc debug", "[0/1/2]", "Disable, enable extensive or enable deferred (binary) debug output.", &DoorControllerModule::cmdDebug},
+    {"dc counters", nullptr, "Print door cycle and wear counters.", &DoorControllerModule::cmdCounters},
+    {"dc counters commit", nullptr, "Write door counters to flash now.", &DoorControllerModule::cmdCountersCommit},
+    {"dc timing", nullptr, "Print learned drive timing.", &DoorControllerModule::cmdTiming},
+    {"dc timing reset", nullptr, "Forget learned drive timing.", &DoorControllerModule::cmdTimingReset},
+    {"dc predictor", nullptr, "Print predictive opening statistics.", &DoorControllerModule::cmdPredictor},
+    {"dc traffic", nullptr, "Print adaptive hold-open statistics.", &DoorControllerModule::cmdTraffic},
+    {"dc direction", nullptr, "Print directional mode statistics.", &DoorControllerModule::cmdDirection},
+    {"dc fsm", nullptr, "Print door state machine state and last transitions.", &DoorControllerModule::cmdFsm},
+    {"dc events", nullptr, "Print internal door event subscribers and statistics.", &DoorControllerModule::cmdEvents},
+    {"dc history", nullptr, "Print door history status (" DOOR_HISTORY_PATH ").", &DoorControllerModule::cmdHistory},
+    {"dc history flush", nullptr, "Write buffered door history to flash.", &DoorControllerModule::cmdHistoryFlush},
+    {"dc history clear", nullptr, "Delete door history.", &DoorControllerModule::cmdHistoryClear},
+    {"dc log", nullptr, "Print deferred debug output.", &DoorControllerModule::cmdLog},
+    {"dc log clear", nullptr, "Clear deferred debug output.", &DoorControllerModule::cmdLogClear},
+    {"dc latency", nullptr, "Print trigger to drive latency statistics.", &DoorControllerModule::cmdLatency},
+    {"dc latency reset", nullptr, "Reset trigger to drive latency statistics.", &DoorControllerModule::cmdLatencyReset},
+#ifdef DOOR_PERF
+    {"dc perf", nullptr, "Print loop stage runtimes (min/avg/max/p99).", &DoorControllerModule::cmdPerf},
+    {"dc perf reset", nullptr, "Reset loop stage runtime statistics.", &DoorControllerModule::cmdPerfReset},
+#endif
+};
+
 void DoorControllerModule::showHelp()
 {
-    logInfo("dc send it1", "Send INIT1 command to door.");
-    logInfo("dc send it2", "Send INIT2 command to door.");
-    logInfo("dc send it3", "Send INIT3 command to door.");
-    logInfo("dc send opg", "Send OPENING command to door.");
-    logInfo("dc send opn", "Send OPEN command to door.");
-    logInfo("dc send clg", "Send CLOSING command to door.");
-    logInfo("dc send cls", "Send CLOSED command to door.");
-    logInfo("dc status", "Print door serial status.");
-    logInfo("dc debug [0/1]", "Enable or disable extensive debug output.");
+    doorConsolePrintHelp(CONSOLE_COMMANDS);
 }
 
 bool DoorControllerModule::processCommand(const std::string cmd, bool diagnoseKo)
 {
-    if (cmd.substr(0, 2) != "dc")
+    static constexpr DoorLookup CONSOLE_LOOKUP(CONSOLE_COMMANDS);
+    static_assert(CONSOLE_LOOKUP.valid(), "Door console: ambiguous command table");
+
+    std::string_view line(cmd);
+    if (line.substr(0, 2) != "dc")
         return false;
 
-    if (cmd.length() > 8 && cmd.compare(0, 8, "dc send ") == 0)
-    {
-        std::string token = cmd.substr(8);
+    std::string_view args;
+    const DoorConsoleCommand<DoorControllerModule> *command = CONSOLE_LOOKUP.findPrefix(line, args);
+    if (command != nullptr && (command->args != nullptr || args.empty()) && (this->*command->handler)(args, diagnoseKo))
+        return true;
 
-        const DoorCommandDefinition *definition = nullptr;
-        for (const auto &entry : COMMAND_LOOKUP)
-        {
-            if (token == entry.token)
-            {
-                definition = entry.definition;
-                break;
-            }
-        }
+    logInfoP("dc (DoorController) command with bad args");
+    if (diagnoseKo)
+        openknx.console.writeDiagenoseKo("dc: bad args");
 
-        if (definition == nullptr)
-        {
-            logInfoP("dc send command with bad args");
-            return false;
-        }
+    return true;
+}
+
+bool DoorControllerModule::cmdSend(std::string_view args, bool diagnoseKo)
+{
+    const DoorCommandDefinition *definition = doorScript.resolve(args);
+    if (definition == nullptr)
+        return false;
+
+    sendDoorCommand(*definition);
+    return true;
+}
+
+bool DoorControllerModule::cmdDefine(std::string_view args, bool diagnoseKo)
+{
+    const size_t space = args.find(' ');
+    const std::string_view name = args.substr(0, space);
+    const std::string_view payloads = space == std::string_view::npos ? std::string_view() : args.substr(space);
+    return doorScript.define(name, payloads);
+}
+
+bool DoorControllerModule::cmdSequences(std::string_view args, bool diagnoseKo)
+{
+    doorScript.printSequences();
+    return true;
+}
+
+bool DoorControllerModule::cmdScript(std::string_view args, bool diagnoseKo)
+{
+    if (args.empty())
+        return false;
+
+    return doorScript.start(args);
+}
 
-        setDoorCommand(*definition);
+bool DoorControllerModule::cmdScriptStop(std::string_view args, bool diagnoseKo)
+{
+    doorScript.stop();
+    return true;
+}
+
+bool DoorControllerModule::cmdCommands(std::string_view args, bool diagnoseKo)
+{
+    doorCommands.printStatus();
+    return true;
+}
+
+bool DoorControllerModule::cmdCommandsLoad(std::string_view args, bool diagnoseKo)
+{
+    // the channels send prefixes directly from the table
+    if (prefixesPending())
+    {
+        logInfoP("Door command in progress, try again");
         return true;
     }
 
-    if (cmd.length() == 9 && cmd.substr(0, 9) == "dc status")
+    doorCommands.load();
+    return true;
+}
+
+bool DoorControllerModule::cmdCommandsReset(std::string_view args, bool diagnoseKo)
+{
+    doorCommands.reset();
+    logInfoP("Built-in door commands restored");
+    return true;
+}
+
+bool DoorControllerModule::cmdRelay(std::string_view args, bool diagnoseKo)
+{
+    doorRelay.printStatus();
+    return true;
+}
+
+bool DoorControllerModule::cmdSensors(std::string_view args, bool diagnoseKo)
+{
+    // bits: inside RAD, inside AIR, outside RAD, outside AIR
+    logInfoP("Sensors 0x%X, routes: open 0x%X, HSK 0x%X, NSK 0x%X", sensorWord, sensorRoutes[ROUTE_OPEN], sensorRoutes[ROUTE_HSK], sensorRoutes[ROUTE_NSK]);
+    if (diagnoseKo)
+        openknx.console.writeDiagenoseKo("sns %X %X%X%X", sensorWord, sensorRoutes[ROUTE_OPEN], sensorRoutes[ROUTE_HSK], sensorRoutes[ROUTE_NSK]);
+    return true;
+}
+
+bool DoorControllerModule::cmdSensorTest(std::string_view args, bool diagnoseKo)
+{
+    doorSensorTest.printStatus();
+    if (diagnoseKo)
+        openknx.console.writeDiagenoseKo("tst %s", doorSensorTest.passed() ? "ok" : "pending");
+    return true;
+}
+
+bool DoorControllerModule::cmdSensorTestRun(std::string_view args, bool diagnoseKo)
+{
+    if (!doorSensorTest.enabled())
     {
-        doorSerial.printStatus();
+        logInfoP("Sensor test disabled");
         return true;
     }
+    doorSensorTest.request(sensorTestSensors());
+    logInfoP("Sensor test requested");
+    return true;
+}
 
-    if (cmd.length() == 10 && cmd.substr(0, 9) == "dc debug ")
-    {
-        if (cmd.substr(9, 1) == "0")
-            doorDebugOutput = false;
-        else if (cmd.substr(9, 1) == "1")
-            doorDebugOutput = true;
+bool DoorControllerModule::cmdSensorTestReset(std::string_view args, bool diagnoseKo)
+{
+    doorSensorTest.resetStatistics();
+    logInfoP("Sensor test statistics reset");
+    return true;
+}
 
-        return true;
+bool DoorControllerModule::cmdStatus(std::string_view args, bool diagnoseKo)
+{
+    uint32_t framesOk = 0;
+    for (DoorChannel &channel : channels)
+    {
+        channel.serial().printStatus();
+        framesOk += channel.serial().getLinkStats().framesOk;
     }
 
-    logInfoP("dc (DoorController) command with bad args");
     if (diagnoseKo)
-        openknx.console.writeDiagenoseKo("dc: bad args");
-    
+    {
+        openknx.console.writeDiagenoseKo("ok %lu", framesOk);
+        openknx.console.writeDiagenoseKo("err %lu", linkErrorCount());
+    }
     return true;
 }
 
-void DoorControllerModule::setDoorCommand(const DoorCommandDefinition &definition)
+bool DoorControllerModule::cmdStatusReset(std::string_view args, bool diagnoseKo)
 {
-    activeDoorPrefixes = (definition.prefixCount > 0 && definition.prefixPayloads != nullptr) ? definition.prefixPayloads : nullptr;
-    activeDoorPrefixCount = (definition.prefixCount > 0 && definition.prefixPayloads != nullptr) ? definition.prefixCount : 0;
-    activeDoorPrefixIndex = 0;
+    for (DoorChannel &channel : channels)
+        channel.serial().resetLinkStats();
+    logInfoP("Door link statistics reset");
+    return true;
+}
 
-    if (definition.finalPayload != nullptr)
-        memcpy(doorDataSending, definition.finalPayload, DOOR_PAYLOAD_SIZE);
+bool DoorControllerModule::cmdDebug(std::string_view args, bool diagnoseKo)
+{
+    if (args == "0")
+    {
+        doorDebugOutput = false;
+        doorDebugDeferred = false;
+    }
+    else if (args == "1")
+    {
+        doorDebugOutput = true;
+        doorDebugDeferred = false;
+    }
+    else if (args == "2")
+    {
+        doorDebugOutput = true;
+        doorDebugDeferred = true;
+    }
     else
-        memset(doorDataSending, 0, DOOR_PAYLOAD_SIZE);
-    doorDataSendingHasData = true;
+    {
+        return false;
+    }
+
+    return true;
+}
+
+bool DoorControllerModule::cmdCounters(std::string_view args, bool diagnoseKo)
+{
+    doorCounters.printStatus();
+    if (diagnoseKo)
+        openknx.console.writeDiagenoseKo("cyc %lu", doorCounters.values().cycles);
+    return true;
+}
+
+bool DoorControllerModule::cmdCountersCommit(std::string_view args, bool diagnoseKo)
+{
+    updateCounters(doorCounters.commit());
+    return true;
+}
+
+bool DoorControllerModule::cmdTiming(std::string_view args, bool diagnoseKo)
+{
+    for (DoorChannel &channel : channels)
+        channel.printTiming();
+    return true;
+}
+
+bool DoorControllerModule::cmdTimingReset(std::string_view args, bool diagnoseKo)
+{
+    for (DoorChannel &channel : channels)
+        channel.timing().reset();
+    updateDriveDegraded();
+    logInfoP("Learned drive timing reset");
+    return true;
+}
+
+bool DoorControllerModule::cmdPredictor(std::string_view args, bool diagnoseKo)
+{
+    doorPredictor.printStatus();
+    return true;
+}
+
+bool DoorControllerModule::cmdTraffic(std::string_view args, bool diagnoseKo)
+{
+    doorTraffic.printStatus();
+    return true;
+}
+
+bool DoorControllerModule::cmdDirection(std::string_view args, bool diagnoseKo)
+{
+    doorDirection.printStatus(doorDirectionAllowed);
+    return true;
+}
+
+bool DoorControllerModule::cmdFsm(std::string_view args, bool diagnoseKo)
+{
+    for (DoorChannel &channel : channels)
+        channel.printTrace();
+    // without "STATE_" to fit into the diagnose KO
+    if (diagnoseKo)
+        openknx.console.writeDiagenoseKo("%s", channels[0].machineStateName() + 6);
+    return true;
+}
+
+bool DoorControllerModule::cmdEvents(std::string_view args, bool diagnoseKo)
+{
+    doorEvents.printStatus();
+    return true;
+}
+
+bool DoorControllerModule::cmdHistory(std::string_view args, bool diagnoseKo)
+{
+    doorHistory.printStatus();
+    return true;
+}
+
+bool DoorControllerModule::cmdHistoryFlush(std::string_view args, bool diagnoseKo)
+{
+    doorHistory.flush();
+    return true;
+}
+
+bool DoorControllerModule::cmdHistoryClear(std::string_view args, bool diagnoseKo)
+{
+    doorHistory.clear();
+    return true;
+}
+
+bool DoorControllerModule::cmdLog(std::string_view args, bool diagnoseKo)
+{
+    doorEventLog.dump();
+    return true;
+}
+
+bool DoorControllerModule::cmdLogClear(std::string_view args, bool diagnoseKo)
+{
+    doorEventLog.clear();
+    return true;
+}
+
+bool DoorControllerModule::cmdLatency(std::string_view args, bool diagnoseKo)
+{
+    printLatencyTrace(diagnoseKo);
+    return true;
+}
+
+bool DoorControllerModule::cmdLatencyReset(std::string_view args, bool diagnoseKo)
+{
+    latencyTriggerToSend.reset();
+    latencySendToDrive.reset();
+    latencyTriggerToDrive.reset();
+    latencyTraceTimeouts = 0;
+    logInfoP("Latency statistics reset");
+    return true;
+}
+
+#ifdef DOOR_PERF
+bool DoorControllerModule::cmdPerf(std::string_view args, bool diagnoseKo)
+{
+    printLoopProfile(diagnoseKo);
+    return true;
+}
+
+bool DoorControllerModule::cmdPerfReset(std::string_view args, bool diagnoseKo)
+{
+    loopProfiler.reset();
+    logInfoP("Loop stage runtime statistics reset");
+    return true;
+}
+#endif
+
+#ifdef DOOR_PERF
+void DoorControllerModule::printLoopProfile(bool diagnoseKo)
+{
+    const uint32_t cyclesPerUs = rp2040.f_cpu() / 1000000;
+
+    logInfoP("Loop stage runtimes in cycles (%lu cycles/us):", cyclesPerUs);
+    logIndentUp();
+    for (uint8_t i = 0; i < STAGE_COUNT; i++)
+    {
+        const DoorLoopStage stage = static_cast<DoorLoopStage>(i);
+        const DoorHistogram &stats = loopProfiler.stats(stage);
+
+        logInfoP("%-30s n=%lu min=%lu avg=%lu max=%lu p99=%lu", DoorLoopProfiler::stageName(stage), stats.count(), stats.min(), stats.avg(), stats.max(), stats.percentile(99));
 
-    memset(lastDataDoorSent, 0, sizeof(lastDataDoorSent));
-    startSending = true;
+        // diagnose KO is limited to 14 chars, so only avg/max in us
+        if (diagnoseKo)
+            openknx.console.writeDiagenoseKo("%s %lu/%lu", DoorLoopProfiler::stageShortName(stage), stats.avg() / cyclesPerUs, stats.max() / cyclesPerUs);
+    }
+    logIndentDown();
+}
+#endif
+
+void DoorControllerModule::printLatencyTrace(bool diagnoseKo)
+{
+    const DoorHistogram *histograms[] = {&latencyTriggerToSend, &latencySendToDrive, &latencyTriggerToDrive};
+    const char *names[] = {"trigger->send", "send->drive", "trigger->drive"};
+    const char *shortNames[] = {"trg", "drv", "tot"};
+
+    logInfoP("Latency in us (traces: %u, timeouts: %lu):", latencyTraceId, latencyTraceTimeouts);
+    logIndentUp();
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        const DoorHistogram &stats = *histograms[i];
+        logInfoP("%-15s n=%lu min=%lu avg=%lu max=%lu p99=%lu", names[i], stats.count(), stats.min(), stats.avg(), stats.max(), stats.percentile(99));
+
+        // diagnose KO is limited to 14 chars, so only avg/max in ms
+        if (diagnoseKo)
+            openknx.console.writeDiagenoseKo("%s %lu/%lu", shortNames[i], stats.avg() / 1000, stats.max() / 1000);
+    }
+    logIndentDown();
 }
 
 DoorControllerModule openknxDoorControllerModule;
\ No newline at end of file
@@ -3,40 +3,31 @@
 #include "OpenKNX.h"
 #include "hardware.h"
 #include "enum-helper.h"
+#include "DoorDrivers.h"
 #include "DoorSerial.h"
+#include "DoorChannel.h"
+#include "DoorLoopProfiler.h"
+#include "DoorHistogram.h"
+#include "DoorLog.h"
+#include "DoorHistory.h"
+#include "DoorEvents.h"
+#include "DoorPersistence.h"
+#include "DoorCounters.h"
+#include "DoorTiming.h"
+#include "DoorPredictor.h"
+#include "DoorTraffic.h"
+#include "DoorDirection.h"
+#include "DoorCommandTable.h"
+#include "DoorScript.h"
+#include "DoorRelay.h"
+#include "DoorSensorTest.h"
+#include "DoorLock.h"
+#include "DoorAirlock.h"
+#include "DoorFsm.h"
+#include "DoorConsole.h"
 
-#define DOOR_SEND_INTERVAL 60
-#define DOOR_SEND_TIMEOUT 150
-
-constexpr uint8_t PAYLOAD_INIT1[]         = {0x00, 0x00, 0x00, 0x52, 0x0B, 0x00, 0x04, 0x06};
-constexpr uint8_t PAYLOAD_INIT2[]         = {0x00, 0x00, 0x00, 0x52, 0x0B, 0x00, 0x04, 0x05};
-constexpr uint8_t PAYLOAD_INIT3[]         = {0x00, 0x00, 0x00, 0x52, 0x0B, 0x00, 0x04, 0x04};
-constexpr uint8_t PAYLOAD_OPEN[]          = {0x00, 0x00, 0x00, 0x52, 0x0B, 0x00, 0x10, 0x04};
-constexpr uint8_t PAYLOAD_CLOSING[]       = {0x00, 0x00, 0x00, 0x52, 0x0B, 0x00, 0x00, 0x01};
-constexpr uint8_t PAYLOAD_CLOSING_PRE1[]  = {0x00, 0x00, 0x00, 0x52, 0x0B, 0x00, 0x12, 0x04}; // radar?
-constexpr uint8_t PAYLOAD_CLOSING_PRE2[]  = {0x00, 0x00, 0x00, 0x52, 0x0B, 0x00, 0x14, 0x04}; // infrared?
-constexpr uint8_t PAYLOAD_CLOSED[]        = {0x00, 0x00, 0x00, 0x52, 0x0B, 0x00, 0x00, 0x03};
-constexpr uint8_t PAYLOAD_OPENING[]       = {0x00, 0x00, 0x00, 0x52, 0x0B, 0x00, 0x10, 0x00};
-constexpr uint8_t PAYLOAD_OPENING_PRE1[]  = {0x00, 0x00, 0x00, 0x52, 0x0B, 0x00, 0x12, 0x03};
-
-// last byte is door state
-#define DOOR_STATE_OPEN       0x04
-#define DOOR_STATE_CLOSED     0x03
-#define DOOR_STATE_CLOSING    0x01
-#define DOOR_STATE_OPENING    0x00
-
-// second last byte is trigger reason
-#define DOOR_TRIGGER_RADAR    0x12
-#define DOOR_TRIGGER_INFRARED 0x14
-
-constexpr size_t DOOR_PAYLOAD_SIZE = sizeof(PAYLOAD_INIT1);
-
-struct DoorCommandDefinition
-{
-  const uint8_t *finalPayload;
-  size_t prefixCount;
-  const uint8_t *const *prefixPayloads;
-};
+#define DOOR_LINK_STATS_INTERVAL 600000
+#define DOOR_POLL_INTERVAL 20 // inputs without change notification (analog, I2C, prog mode)
 
 class DoorControllerModule : public OpenKNX::Module
 {
@@ -55,69 +46,142 @@ class DoorControllerModule : public OpenKNX::Module
     void showHelp() override;
     bool processCommand(const std::string cmd, bool diagnoseKo) override;
 
+    // internal bindings of other modules, see DoorEvents.h
+    DoorEvents doorEvents;
+    // status KO of an event, set to the value of the record, nullptr if there is none
+    GroupObject *eventKo(const DoorEvents::Record &record);
+
   private:
-    enum DoorState
-    {
-        CLOSED,
-        CLOSING,
-        OPEN,
-        OPENING,
-        UNDEFINED
-    };
+    friend class DoorChannel;
+    using DoorState = DoorChannel::DoorState;
 
     enum DoorMode
     {
         ALWAYS_CLOSED,
         ALWAYS_OPEN,
         MANUAL,
-        AUTOMATIC
+        AUTOMATIC,
+        AIRLOCK,    // automatic, only one channel open at a time
+        DIRECTIONAL // automatic, only for the direction of KoDOR_DoorDirection
+    };
+
+    // packed sensor inputs, bit order of the ETS routing parameters
+    enum SensorBit : uint8_t
+    {
+        SENSOR_BIT_INSIDE_RAD = 0x01,
+        SENSOR_BIT_INSIDE_AIR = 0x02,
+        SENSOR_BIT_OUTSIDE_RAD = 0x04,
+        SENSOR_BIT_OUTSIDE_AIR = 0x08,
+        SENSOR_BITS_INSIDE = SENSOR_BIT_INSIDE_RAD | SENSOR_BIT_INSIDE_AIR,
+        SENSOR_BITS_OUTSIDE = SENSOR_BIT_OUTSIDE_RAD | SENSOR_BIT_OUTSIDE_AIR,
+        SENSOR_BITS_AIR = SENSOR_BIT_INSIDE_AIR | SENSOR_BIT_OUTSIDE_AIR,
+        SENSOR_BITS_ALL = SENSOR_BITS_INSIDE | SENSOR_BITS_OUTSIDE
+    };
+
+    // functions a sensor can be routed to (ETS "Sensorzuordnung")
+    enum SensorRoute : uint8_t
+    {
+        ROUTE_OPEN,
+        ROUTE_HSK,
+        ROUTE_NSK,
+        ROUTE_COUNT
     };
 
-    enum DoorStateMachine
+    // loop stages to run, see loop()
+    enum DoorLoopDirty : uint8_t
     {
-        STATE_UNDEFINED,
-        STATE_TRANSITION,
-        STATE_OPEN_START,
-        STATE_OPEN,
-        STATE_CLOSED,
-        STATE_CLOSED_LOCKED
+        DIRTY_SENSORS = 0x01,    // sensor ISR fired
+        DIRTY_DOOR_STATE = 0x02, // drive reported a new state
+        DIRTY_POLL = 0x04,       // DOOR_POLL_INTERVAL elapsed
+        DIRTY_OUTPUTS = 0x08,    // an input of updateExtensionOutputs changed
+        DIRTY_ALL = 0x0F
     };
 
+    DoorChannel channels[DOOR_CHANNEL_COUNT];
+    // all channels combined, see combinedDoorState()
     DoorState doorState = DoorState::UNDEFINED;
     DoorState doorStatePrevious = DoorState::UNDEFINED;
     DoorMode doorMode = DoorMode::AUTOMATIC;
-    DoorStateMachine doorStateMachine = DoorStateMachine::STATE_UNDEFINED;
-    DoorStateMachine doorStateMachinePrevious = DoorStateMachine::STATE_UNDEFINED;
+    DoorFsmTimer fsmPredictorTimer;
+    DoorFsmTimer fsmDirectionTimer;
     bool mainPwrActive = false;
-    bool mainMldActive = false;
     bool mainHskActive = false;
     bool mainNskActive = false;
-    bool mainLckActive = false;
     bool switchInsideTrigger = false;
     bool switchOutsideTrigger = false;
-    bool lockRequested = false;
+    bool switchTriggerUsed = false;
     bool lockActive = false;
-    unsigned long mainMdlStart = 0;
-    bool doorStateChanged = false;
-    unsigned long doorStateLastChanged = 0;
-    unsigned long doorOpenSince = 0;
-    unsigned long mainLckStart = 0;
-    unsigned long lastLockRequestMld = 0;
-
-    uint32_t lastDoorSent = 0;
-    bool startSending = false;
-    bool nextMessageReceived = false;
-    bool doorDataSendingHasData = false;
-    uint8_t doorDataSending[DOOR_PAYLOAD_SIZE] = {};
-    uint8_t lastDataDoorSent[DOOR_PAYLOAD_SIZE] = {};
-    uint8_t lastDataDoorReceived[DOOR_PAYLOAD_SIZE] = {};
+    DoorLock doorLock;
+
     bool doorDebugOutput = false;
+    bool doorDebugDeferred = false;
+    DoorEventLog doorEventLog;
+    DoorHistory doorHistory;
+    DoorCounters doorCounters;
+    bool doorTimingDegraded = false;
+    DoorPredictor doorPredictor;
+    DoorTraffic doorTraffic;
+    DoorDirection doorDirection;
+    DoorDirection::Direction doorDirectionAllowed = DoorDirection::EXIT;
+    DoorCommandTable doorCommands;
+    DoorScript doorScript;
+    DoorRelay doorRelay;
+    DoorSensorTest doorSensorTest;
+    uint32_t lastLinkStatsSent = 0;
+    uint8_t loopDirty = DIRTY_ALL;
+    uint32_t lastPoll = 0;
+
+    // latency traces run per channel (DoorChannel::startLatencyTrace), statistics are shared
+    uint16_t latencyTraceId = 0;
+    uint32_t latencyTraceTimeouts = 0;
+    uint32_t sensorEventAt = 0; // micros of the sensor change behind FSM_EVENT_SENSOR
+    DoorHistogram latencyTriggerToSend;
+    DoorHistogram latencySendToDrive;
+    DoorHistogram latencyTriggerToDrive;
 
-    const uint8_t *const *activeDoorPrefixes = nullptr;
-    size_t activeDoorPrefixCount = 0;
-    size_t activeDoorPrefixIndex = 0;
+#ifdef DOOR_PERF
+    DoorLoopProfiler loopProfiler;
+    void printLoopProfile(bool diagnoseKo);
+#endif
 
-    DoorSerial doorSerial = DoorSerial();
+    static const DoorConsoleCommand<DoorControllerModule> CONSOLE_COMMANDS[];
+    // console handlers, false on bad args
+    bool cmdSend(std::string_view args, bool diagnoseKo);
+    bool cmdDefine(std::string_view args, bool diagnoseKo);
+    bool cmdSequences(std::string_view args, bool diagnoseKo);
+    bool cmdScript(std::string_view args, bool diagnoseKo);
+    bool cmdScriptStop(std::string_view args, bool diagnoseKo);
+    bool cmdCommands(std::string_view args, bool diagnoseKo);
+    bool cmdCommandsLoad(std::string_view args, bool diagnoseKo);
+    bool cmdCommandsReset(std::string_view args, bool diagnoseKo);
+    bool cmdRelay(std::string_view args, bool diagnoseKo);
+    bool cmdSensors(std::string_view args, bool diagnoseKo);
+    bool cmdSensorTest(std::string_view args, bool diagnoseKo);
+    bool cmdSensorTestRun(std::string_view args, bool diagnoseKo);
+    bool cmdSensorTestReset(std::string_view args, bool diagnoseKo);
+    bool cmdStatus(std::string_view args, bool diagnoseKo);
+    bool cmdStatusReset(std::string_view args, bool diagnoseKo);
+    bool cmdDebug(std::string_view args, bool diagnoseKo);
+    bool cmdCounters(std::string_view args, bool diagnoseKo);
+    bool cmdCountersCommit(std::string_view args, bool diagnoseKo);
+    bool cmdTiming(std::string_view args, bool diagnoseKo);
+    bool cmdTimingReset(std::string_view args, bool diagnoseKo);
+    bool cmdPredictor(std::string_view args, bool diagnoseKo);
+    bool cmdTraffic(std::string_view args, bool diagnoseKo);
+    bool cmdDirection(std::string_view args, bool diagnoseKo);
+    bool cmdFsm(std::string_view args, bool diagnoseKo);
+    bool cmdEvents(std::string_view args, bool diagnoseKo);
+    bool cmdHistory(std::string_view args, bool diagnoseKo);
+    bool cmdHistoryFlush(std::string_view args, bool diagnoseKo);
+    bool cmdHistoryClear(std::string_view args, bool diagnoseKo);
+    bool cmdLog(std::string_view args, bool diagnoseKo);
+    bool cmdLogClear(std::string_view args, bool diagnoseKo);
+    bool cmdLatency(std::string_view args, bool diagnoseKo);
+    bool cmdLatencyReset(std::string_view args, bool diagnoseKo);
+#ifdef DOOR_PERF
+    bool cmdPerf(std::string_view args, bool diagnoseKo);
+    bool cmdPerfReset(std::string_view args, bool diagnoseKo);
+#endif
 
     unsigned long extProgSwitchLastTrigger = 0;
 
@@ -152,19 +216,57 @@ class DoorControllerModule : public OpenKNX::Module
     bool lastExtLockRqt = false;
 
     bool mainTstActive = false;
-    bool sensorTstActive = false;
     bool sensorInsideRadActive = false;
     bool sensorInsideAirActive = false;
     bool sensorOutsideRadActive = false;
     bool sensorOutsideAirActive = false;
+    uint8_t sensorWord = 0;
+    uint8_t sensorRoutes[ROUTE_COUNT] = {SENSOR_BIT_INSIDE_RAD | SENSOR_BIT_OUTSIDE_RAD, 0, 0};
+    inline volatile static bool sensorsChanged = true;
     inline volatile static bool sensorInsideRadActiveNew = false;
     inline volatile static bool sensorInsideAirActiveNew = false;
     inline volatile static bool sensorOutsideRadActiveNew = false;
     inline volatile static bool sensorOutsideAirActiveNew = false;
+    inline volatile static uint32_t sensorInsideRadChangedAt = 0;
+    inline volatile static uint32_t sensorOutsideRadChangedAt = 0;
+    inline volatile static uint32_t sensorInsideAirChangedAt = 0;
+    inline volatile static uint32_t sensorOutsideAirChangedAt = 0;
 
     void enableExtInterface();
-    void doorMessageCallback(const std::vector<uint8_t>& payload);
+    inline bool takeDirty(uint8_t stage)
+    {
+        if ((loopDirty & stage) == 0)
+            return false;
+        loopDirty &= ~stage;
+        return true;
+    }
+    void applyDoorMode(DoorMode mode);
+    // use: what relies on the door state of the contact interface
+    void warnRelayState(const char *use);
+    void applyDoorDirection(DoorDirection::Direction direction);
+    void processDirection(bool inside, bool active, uint32_t changedAt);
+    void publishSensor(SensorBit bit, bool active);
+    void raiseChannels(uint8_t events);
+    // FSM_EVENT_SENSOR for all channels, changedAt in micros
+    void raiseSensorEvent(uint32_t changedAt);
+    bool openAllowed(uint8_t channel);
+    bool airlockWaiting(uint8_t channel);
+    void airlockChannels(DoorAirlockChannel (&airlock)[DOOR_CHANNEL_COUNT]);
+    inline void updateSensorWord(uint8_t bit, bool active) { sensorWord = active ? (sensorWord | bit) : (sensorWord & ~bit); }
+    uint8_t sensorSide(uint8_t channel);
+    bool radarActive(uint8_t channel);
+    bool airActive(uint8_t channel);
+    uint8_t sensorTestSensors();
+    DoorState combinedDoorState();
+    uint32_t linkErrorCount();
+    // all channels, via the scheduled send path of DoorChannel
+    void sendDoorCommand(const DoorCommandDefinition &definition);
+    // any channel, see DoorChannel::prefixesPending()
+    bool prefixesPending(const uint8_t *const *prefixes = nullptr);
     void processDoorSerial();
+    void publishLinkStats();
+    void updateCounters(bool send);
+    void updateDriveDegraded();
     void processSensorInsideRadChange();
     void processSensorInsideAirChange();
     void processSensorOutsideRadChange();
@@ -176,10 +278,13 @@ class DoorControllerModule : public OpenKNX::Module
     void processDoorStateMachine();
     void processManualMachine();
     void updateExtensionOutputs();
-    void sendMainMld(bool active);
+    void requestLock(bool active);
+    void processLock();
+    void applyLockActions(uint8_t actions);
     void lock(bool active);
+    void setLockStatus(bool locked);
 
-    void setDoorCommand(const DoorCommandDefinition &definition);
+    void printLatencyTrace(bool diagnoseKo);
 
     static void interruptSensorInsideRadChange();
     static void interruptSensorInsideAirChange();
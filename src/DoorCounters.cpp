@@ -0,0 +1,164 @@
+#include "DoorCounters.h"
+#include "DoorPersistence.h"
+#include <LittleFS.h>
+
+void DoorCounters::begin()
+{
+    _ready = LittleFS.begin();
+    if (!_ready)
+    {
+        logErrorP("LittleFS not available, counters are not persisted");
+        return;
+    }
+
+    if (!LittleFS.exists("/door"))
+        LittleFS.mkdir("/door");
+
+    if (!load())
+        logDebugP("No valid counter snapshot found");
+
+    _lastCommit = delayTimerInit();
+}
+
+bool DoorCounters::load()
+{
+    // a compaction interrupted by power loss may leave the snapshot in the new file only
+    const bool loaded = load(DOOR_COUNTERS_PATH);
+    return load(DOOR_COUNTERS_PATH_NEW) || loaded;
+}
+
+bool DoorCounters::load(const char *path)
+{
+    File file = LittleFS.open(path, "r");
+    if (!file)
+        return false;
+
+    // last valid snapshot wins, a torn write at the end is skipped
+    const size_t count = file.size() / sizeof(Snapshot);
+    for (size_t i = count; i > 0; i--)
+    {
+        Snapshot snapshot;
+        file.seek((i - 1) * sizeof(Snapshot));
+        if (file.read(reinterpret_cast<uint8_t *>(&snapshot), sizeof(Snapshot)) != sizeof(Snapshot))
+            continue;
+
+        if (snapshot.crc != doorFlashCrc16(reinterpret_cast<const uint8_t *>(&snapshot), offsetof(Snapshot, crc)))
+            continue;
+
+        file.close();
+        _sequence = std::max(_sequence, snapshot.sequence);
+        merge(snapshot.values);
+        logDebugP("Counters loaded from %s (sequence %lu): cycles %lu, runtime %lu s, lock %lu", path, snapshot.sequence, _values.cycles, _values.runtime, _values.lockActuations);
+        return true;
+    }
+
+    file.close();
+    return false;
+}
+
+bool DoorCounters::loop()
+{
+    if (!_dirty)
+        return false;
+
+    if (_cyclesSinceCommit >= DOOR_COUNTERS_COMMIT_CYCLES || delayCheckMillis(_lastCommit, DOOR_COUNTERS_COMMIT_INTERVAL))
+        return commit();
+
+    return false;
+}
+
+bool DoorCounters::commit()
+{
+    _lastCommit = delayTimerInit();
+    if (!_ready)
+        return false;
+
+    Snapshot snapshot = {};
+    snapshot.sequence = ++_sequence;
+    snapshot.values = _values;
+    snapshot.crc = doorFlashCrc16(reinterpret_cast<const uint8_t *>(&snapshot), offsetof(Snapshot, crc));
+
+    File file = LittleFS.open(DOOR_COUNTERS_PATH, "r");
+    const size_t fileSize = file ? file.size() : 0;
+    if (file)
+        file.close();
+
+    if (fileSize + sizeof(Snapshot) > DOOR_COUNTERS_FILE_SIZE)
+    {
+        // compact: start a new file with the current snapshot only, the
+        // rename replaces the old file atomically
+        LittleFS.remove(DOOR_COUNTERS_PATH_NEW);
+        if (!append(DOOR_COUNTERS_PATH_NEW, snapshot))
+            return false;
+
+        if (!LittleFS.rename(DOOR_COUNTERS_PATH_NEW, DOOR_COUNTERS_PATH))
+        {
+            logErrorP("Could not replace %s", DOOR_COUNTERS_PATH);
+            return false;
+        }
+    }
+    else if (!append(DOOR_COUNTERS_PATH, snapshot))
+    {
+        return false;
+    }
+
+    _dirty = false;
+    _cyclesSinceCommit = 0;
+    return true;
+}
+
+bool DoorCounters::append(const char *path, const Snapshot &snapshot)
+{
+    File file = LittleFS.open(path, "a");
+    if (!file)
+    {
+        logErrorP("Could not open %s", path);
+        return false;
+    }
+
+    const size_t written = file.write(reinterpret_cast<const uint8_t *>(&snapshot), sizeof(Snapshot));
+    file.close();
+    return written == sizeof(Snapshot);
+}
+
+void DoorCounters::merge(const Values &values)
+{
+    _values.cycles = std::max(_values.cycles, values.cycles);
+    _values.runtime = std::max(_values.runtime, values.runtime);
+    _values.lockActuations = std::max(_values.lockActuations, values.lockActuations);
+}
+
+void DoorCounters::addCycle()
+{
+    _values.cycles++;
+    _cyclesSinceCommit++;
+    _dirty = true;
+}
+
+void DoorCounters::addRuntime(uint32_t ms)
+{
+    _runtimeRemainder += ms;
+    if (_runtimeRemainder < 1000)
+        return;
+
+    _values.runtime += _runtimeRemainder / 1000;
+    _runtimeRemainder %= 1000;
+    _dirty = true;
+}
+
+void DoorCounters::addLockActuation()
+{
+    _values.lockActuations++;
+    _dirty = true;
+}
+
+void DoorCounters::printStatus()
+{
+    logInfoP("Door counters:");
+    logIndentUp();
+    logInfoP("Cycles: %lu", _values.cycles);
+    logInfoP("Motor runtime: %lu s", _values.runtime);
+    logInfoP("Lock actuations: %lu", _values.lockActuations);
+    logInfoP("Snapshot sequence: %lu%s", _sequence, _dirty ? " (uncommitted changes)" : "");
+    logIndentDown();
+}
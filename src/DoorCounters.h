@@ -0,0 +1,69 @@
+#pragma once
+#include <Arduino.h>
+#include <cstddef>
+#include <cstdint>
+#include "OpenKNX.h"
+
+#define DOOR_COUNTERS_PATH "/door/counters.bin"
+#define DOOR_COUNTERS_PATH_NEW "/door/counters.new.bin"
+#define DOOR_COUNTERS_FILE_SIZE 4096
+#define DOOR_COUNTERS_COMMIT_CYCLES 50
+#define DOOR_COUNTERS_COMMIT_INTERVAL 3600000
+
+// DoorCounters keeps service counters (door cycles, motor run time, lock
+// actuations) in RAM and commits them log-structured: every commit appends
+// one small snapshot to a LittleFS file instead of rewriting a fixed
+// location. On boot the last valid snapshot wins. When the file is full it
+// is compacted to a single snapshot in DOOR_COUNTERS_PATH_NEW, which is
+// renamed over the old file; load() reads both files.
+// Counters are also part of the module's flash block (saved on power
+// failure), both sources are merged by taking the larger value per counter.
+
+class DoorCounters
+{
+  public:
+    struct Values
+    {
+        uint32_t cycles;
+        uint32_t runtime; // seconds
+        uint32_t lockActuations;
+    };
+
+    void begin();
+    // returns true if the counters were committed
+    bool loop();
+    bool commit();
+    void merge(const Values &values);
+
+    void addCycle();
+    void addRuntime(uint32_t ms);
+    void addLockActuation();
+
+    inline const Values &values() const { return _values; }
+    void printStatus();
+
+    std::string logPrefix() { return "DoorCounters"; }
+
+  private:
+    struct Snapshot
+    {
+        uint32_t sequence;
+        Values values;
+        uint16_t crc;
+        uint16_t reserved;
+    };
+
+    static_assert(sizeof(Snapshot) == 20, "DoorCounters snapshot must stay 20 bytes");
+
+    Values _values = {};
+    uint32_t _sequence = 0;
+    uint32_t _runtimeRemainder = 0;
+    uint32_t _lastCommit = 0;
+    uint16_t _cyclesSinceCommit = 0;
+    bool _dirty = false;
+    bool _ready = false;
+
+    bool load();
+    bool load(const char *path);
+    bool append(const char *path, const Snapshot &snapshot);
+};
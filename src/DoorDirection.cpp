@@ -0,0 +1,42 @@
+#include "DoorDirection.h"
+
+bool DoorDirection::followsOther(uint8_t side) const
+{
+    const uint8_t other = 1 - side;
+    return _seen[other] && _rise[side] - _rise[other] < DOOR_DIRECTION_WINDOW;
+}
+
+DoorDirection::Direction DoorDirection::radarChanged(bool inside, bool active, uint32_t edge)
+{
+    const uint8_t side = inside ? EXIT : ENTRY;
+    _active[side] = active;
+    if (!active)
+        return NONE;
+
+    _rise[side] = edge;
+    _seen[side] = true;
+    if (followsOther(side))
+        return NONE;
+
+    _approaches[side]++;
+    logDebugP("Approach: %s", side == EXIT ? "exit" : "entry");
+    return static_cast<Direction>(side);
+}
+
+bool DoorDirection::approaching(Direction direction, uint32_t now) const
+{
+    if (direction == NONE || !_active[direction])
+        return false;
+
+    // a presence that stays is a person waiting to pass, whatever the other side did
+    return !followsOther(direction) || now - _rise[direction] >= DOOR_DIRECTION_WINDOW;
+}
+
+void DoorDirection::printStatus(Direction allowed)
+{
+    logInfoP("Direction: %s only", allowed == EXIT ? "exit" : "entry");
+    logIndentUp();
+    logInfoP("Approaches: exit %lu, entry %lu", _approaches[EXIT], _approaches[ENTRY]);
+    logInfoP("Skipped cycles: %lu", _skipped);
+    logIndentDown();
+}
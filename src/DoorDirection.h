@@ -0,0 +1,51 @@
+#pragma once
+#include <Arduino.h>
+#include <cstddef>
+#include <cstdint>
+#include "OpenKNX.h"
+
+#define DOOR_DIRECTION_WINDOW 2000 // ms, an edge this soon after the other radar's edge belongs to its approach
+
+// DoorDirection infers the walking direction for the directional door mode
+// (exit only / entry only, switched via KO e.g. for the night). The radar on
+// the side a person comes from triggers first, the other one only once the
+// person is close to or in the door. Each rising edge is judged on its own:
+// it starts an approach from its side unless the other radar rose less than
+// DOOR_DIRECTION_WINDOW before (the same person walking through or seen
+// through the glass). Presence on the blocked side never suppresses the
+// allowed side: the other radar staying active (someone waiting outside,
+// street traffic) does not count, and an allowed-side radar that stays
+// active for DOOR_DIRECTION_WINDOW opens the door in any case. An approach
+// from the blocked side does not open the door, it is counted as a skipped
+// cycle.
+
+class DoorDirection
+{
+  public:
+    enum Direction : uint8_t
+    {
+        EXIT,  // inside to outside
+        ENTRY, // outside to inside
+        NONE
+    };
+
+    // edge: time of the edge (ms), returns the direction of an approach started by it, else NONE
+    Direction radarChanged(bool inside, bool active, uint32_t edge);
+    // a person on the side of direction wants to pass
+    bool approaching(Direction direction, uint32_t now) const;
+    inline void skipped() { _skipped++; }
+
+    void printStatus(Direction allowed);
+    std::string logPrefix() { return "DoorDirection"; }
+
+  private:
+    // index by side, inside = EXIT, outside = ENTRY
+    bool _active[NONE] = {};
+    bool _seen[NONE] = {};
+    uint32_t _rise[NONE] = {};
+    uint32_t _approaches[NONE] = {};
+    uint32_t _skipped = 0;
+
+    // the last rising edge of side followed one of the other side within the window
+    bool followsOther(uint8_t side) const;
+};
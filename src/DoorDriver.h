@@ -0,0 +1,147 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Drive protocol interface. Everything that depends on the drive model
+// (framing, payload size, where the state is reported, built-in commands)
+// lives in a driver class that derives from DoorDriver<Driver> (CRTP) and
+// provides:
+//
+//   PAYLOAD_SIZE                 size of all command and state payloads
+//   RX_SIZE                      largest payload accepted on receive
+//   frameSize(length)            largest frame for a payload of length bytes
+//   encodeFrame(payload, length, frame)  returns the frame length
+//   receiveByte(byte)            DoorDriverRx, on FRAME payload()/payloadLength()
+//   resetReceive()
+//   decodeState(payload)         DoorDriverState of a PAYLOAD_SIZE payload
+//   rawState(payload)            state byte for diagnostics
+//   builtinCommand(id)           compiled-in command set, see DoorCommandTable
+//
+// The driver is selected at compile time (DOOR_DRIVER, see DoorDrivers.h),
+// so calls are resolved statically and inlined into DoorSerial and
+// DoorChannel, there is no virtual call in the send/receive path.
+// conforms() runs the built-in commands through the driver at compile time.
+
+struct DoorCommandDefinition
+{
+  const uint8_t *finalPayload;
+  size_t prefixCount;
+  const uint8_t *const *prefixPayloads;
+};
+
+// index into DoorCommandTable, order of the binary command table
+enum DoorCommandId : uint8_t
+{
+    DOOR_COMMAND_INIT1,
+    DOOR_COMMAND_INIT2,
+    DOOR_COMMAND_INIT3,
+    DOOR_COMMAND_OPEN,
+    DOOR_COMMAND_CLOSING,
+    DOOR_COMMAND_CLOSED,
+    DOOR_COMMAND_OPENING,
+    DOOR_COMMAND_COUNT
+};
+
+enum class DoorDriverState : uint8_t
+{
+    OPENING,
+    CLOSING,
+    OPEN,
+    CLOSED,
+    UNKNOWN
+};
+
+enum class DoorDriverRx : uint8_t
+{
+    NONE, // byte consumed, frame not complete
+    FRAME,
+    CHECKSUM_ERROR,
+    FRAMING_ERROR,
+    OVERSIZE
+};
+
+template <typename T, size_t N>
+constexpr size_t arrayCount(const T (&)[N])
+{
+    return N;
+}
+
+template <typename Driver>
+class DoorDriver
+{
+  public:
+    inline size_t encode(const uint8_t *payload, size_t length, uint8_t *frame) const
+    {
+        return driver().encodeFrame(payload, length, frame);
+    }
+
+    inline DoorDriverRx receive(uint8_t byte)
+    {
+        return driver().receiveByte(byte);
+    }
+
+    static constexpr DoorDriverState state(const uint8_t *payload)
+    {
+        return Driver::decodeState(payload);
+    }
+
+    static constexpr const DoorCommandDefinition &command(DoorCommandId id)
+    {
+        return Driver::builtinCommand(id);
+    }
+
+    // every built-in payload survives encode/receive unchanged and the
+    // state commands decode as the state they request
+    static constexpr bool conforms()
+    {
+        for (uint8_t id = 0; id < DOOR_COMMAND_COUNT; id++)
+        {
+            const DoorCommandDefinition &definition = Driver::builtinCommand(static_cast<DoorCommandId>(id));
+            if (definition.finalPayload == nullptr || (definition.prefixCount > 0 && definition.prefixPayloads == nullptr))
+                return false;
+
+            for (size_t i = 0; i < definition.prefixCount; i++)
+            {
+                if (!roundTrip(definition.prefixPayloads[i]))
+                    return false;
+            }
+
+            if (!roundTrip(definition.finalPayload))
+                return false;
+        }
+
+        return Driver::decodeState(Driver::builtinCommand(DOOR_COMMAND_OPEN).finalPayload) == DoorDriverState::OPEN &&
+               Driver::decodeState(Driver::builtinCommand(DOOR_COMMAND_CLOSED).finalPayload) == DoorDriverState::CLOSED &&
+               Driver::decodeState(Driver::builtinCommand(DOOR_COMMAND_OPENING).finalPayload) == DoorDriverState::OPENING &&
+               Driver::decodeState(Driver::builtinCommand(DOOR_COMMAND_CLOSING).finalPayload) == DoorDriverState::CLOSING;
+    }
+
+  private:
+    inline Driver &driver() { return static_cast<Driver &>(*this); }
+    inline const Driver &driver() const { return static_cast<const Driver &>(*this); }
+
+    static constexpr bool roundTrip(const uint8_t *payload)
+    {
+        uint8_t frame[Driver::frameSize(Driver::PAYLOAD_SIZE)] = {};
+        Driver receiver;
+        const size_t length = receiver.encodeFrame(payload, Driver::PAYLOAD_SIZE, frame);
+
+        DoorDriverRx result = DoorDriverRx::NONE;
+        for (size_t i = 0; i < length; i++)
+        {
+            result = receiver.receiveByte(frame[i]);
+            if (result != DoorDriverRx::NONE && i + 1 < length)
+                return false;
+        }
+
+        if (result != DoorDriverRx::FRAME || receiver.payloadLength() != Driver::PAYLOAD_SIZE)
+            return false;
+
+        for (size_t i = 0; i < Driver::PAYLOAD_SIZE; i++)
+        {
+            if (receiver.payload()[i] != payload[i])
+                return false;
+        }
+        return true;
+    }
+};
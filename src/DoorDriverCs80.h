@@ -0,0 +1,193 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "DoorDriver.h"
+#include "DoorProtocol.h"
+
+// dormakaba CS 80 Magneo: payloads framed by DLE/STX and DLE/ETX, a DLE in the
+// payload is doubled, followed by an XOR checksum over the transmitted
+// (stuffed) payload bytes. The last payload byte holds the door state.
+
+class DoorDriverCs80 : public DoorDriver<DoorDriverCs80>
+{
+  public:
+    static constexpr const char *NAME = "CS 80 Magneo";
+    static constexpr size_t PAYLOAD_SIZE = DOOR_CS80_PAYLOAD_SIZE;
+    static constexpr size_t RX_SIZE = 128;
+
+    // every payload byte may be stuffed, plus DLE STX, DLE ETX and checksum
+    static constexpr size_t frameSize(size_t length)
+    {
+        return length * 2 + 5;
+    }
+
+    constexpr size_t encodeFrame(const uint8_t *payload, size_t length, uint8_t *frame) const
+    {
+        size_t frameLength = 0;
+        frame[frameLength++] = DLE;
+        frame[frameLength++] = STX;
+
+        uint8_t checksum = 0x00;
+        for (size_t i = 0; i < length; ++i)
+        {
+            const uint8_t byte = payload[i];
+            if (byte == DLE)
+            {
+                frame[frameLength++] = DLE;
+                frame[frameLength++] = DLE;
+                checksum ^= DLE;
+                checksum ^= DLE;
+            }
+            else
+            {
+                frame[frameLength++] = byte;
+                checksum ^= byte;
+            }
+        }
+
+        frame[frameLength++] = DLE;
+        frame[frameLength++] = ETX;
+        frame[frameLength++] = checksum;
+        return frameLength;
+    }
+
+    constexpr DoorDriverRx receiveByte(uint8_t byte)
+    {
+        switch (_rxState)
+        {
+            case RxState::Idle:
+                if (byte == DLE)
+                    _rxState = RxState::AwaitStx;
+                break;
+
+            case RxState::AwaitStx:
+                if (byte == STX)
+                {
+                    _rxLength = 0;
+                    _checksum = 0x00;
+                    _rxState = RxState::InFrame;
+                }
+                else if (byte != DLE)
+                {
+                    _rxState = RxState::Idle;
+                }
+                break;
+
+            case RxState::InFrame:
+                if (byte == DLE)
+                {
+                    _rxState = RxState::AfterDle;
+                    break;
+                }
+                if (_rxLength >= RX_SIZE)
+                {
+                    resetReceive();
+                    return DoorDriverRx::OVERSIZE;
+                }
+                _rxBuffer[_rxLength++] = byte;
+                _checksum ^= byte;
+                break;
+
+            case RxState::AfterDle:
+                if (byte == DLE)
+                {
+                    if (_rxLength >= RX_SIZE)
+                    {
+                        resetReceive();
+                        return DoorDriverRx::OVERSIZE;
+                    }
+                    _checksum ^= DLE;
+                    _checksum ^= DLE;
+                    _rxBuffer[_rxLength++] = DLE;
+                    _rxState = RxState::InFrame;
+                }
+                else if (byte == ETX)
+                {
+                    _rxState = RxState::AwaitChecksum;
+                }
+                else
+                {
+                    resetReceive();
+                    return DoorDriverRx::FRAMING_ERROR;
+                }
+                break;
+
+            case RxState::AwaitChecksum:
+            {
+                const bool valid = byte == _checksum;
+                _rxState = RxState::Idle;
+                return valid ? DoorDriverRx::FRAME : DoorDriverRx::CHECKSUM_ERROR;
+            }
+        }
+        return DoorDriverRx::NONE;
+    }
+
+    constexpr void resetReceive()
+    {
+        _rxState = RxState::Idle;
+        _checksum = 0x00;
+        _rxLength = 0;
+    }
+
+    // valid after receiveByte() returned FRAME until the next byte
+    constexpr const uint8_t *payload() const { return _rxBuffer; }
+    constexpr size_t payloadLength() const { return _rxLength; }
+
+    static constexpr uint8_t rawState(const uint8_t *payload)
+    {
+        return payload[PAYLOAD_SIZE - 1];
+    }
+
+    static constexpr DoorDriverState decodeState(const uint8_t *payload)
+    {
+        switch (rawState(payload))
+        {
+            case DOOR_STATE_OPEN:
+                return DoorDriverState::OPEN;
+            case DOOR_STATE_CLOSED:
+                return DoorDriverState::CLOSED;
+            case DOOR_STATE_CLOSING:
+                return DoorDriverState::CLOSING;
+            case DOOR_STATE_OPENING:
+                return DoorDriverState::OPENING;
+            default:
+                return DoorDriverState::UNKNOWN;
+        }
+    }
+
+    static constexpr const DoorCommandDefinition &builtinCommand(DoorCommandId id)
+    {
+        return *COMMANDS[id];
+    }
+
+  private:
+    enum class RxState : uint8_t
+    {
+        Idle,
+        AwaitStx,
+        InFrame,
+        AfterDle,
+        AwaitChecksum
+    };
+
+    static constexpr uint8_t DLE = 0x10;
+    static constexpr uint8_t STX = 0x02;
+    static constexpr uint8_t ETX = 0x03;
+
+    // DoorCommandId order
+    static constexpr const DoorCommandDefinition *COMMANDS[] = {
+        &COMMAND_INIT1,
+        &COMMAND_INIT2,
+        &COMMAND_INIT3,
+        &COMMAND_OPEN,
+        &COMMAND_CLOSING,
+        &COMMAND_CLOSED,
+        &COMMAND_OPENING,
+    };
+    static_assert(arrayCount(COMMANDS) == DOOR_COMMAND_COUNT, "DoorDriverCs80: commands do not match DoorCommandId");
+
+    RxState _rxState = RxState::Idle;
+    uint8_t _checksum = 0x00;
+    uint8_t _rxBuffer[RX_SIZE] = {};
+    size_t _rxLength = 0;
+};
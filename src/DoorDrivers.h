@@ -0,0 +1,16 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "hardware.h"
+#include "DoorDriver.h"
+#include "DoorDriverCs80.h"
+
+// Drive protocol selected by DOOR_DRIVER (hardware.h). A new drive model
+// gets its own DoorDriver<...> header, included here.
+
+using DoorActiveDriver = DOOR_DRIVER;
+
+static_assert(DoorActiveDriver::conforms(), "Door driver: built-in commands do not survive encode/receive");
+
+// buffers of generic code are sized for the active driver
+constexpr size_t DOOR_PAYLOAD_SIZE = DoorActiveDriver::PAYLOAD_SIZE;
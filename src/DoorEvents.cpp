@@ -0,0 +1,59 @@
+#include "DoorEvents.h"
+
+bool DoorEvents::subscribe(uint8_t events, Callback callback, void *context)
+{
+    if (_subscriberCount >= DOOR_EVENTS_SUBSCRIBERS)
+    {
+        logErrorP("No free subscriber slot");
+        return false;
+    }
+
+    _subscribers[_subscriberCount++] = {callback, context, (uint8_t)(events & EVENTS_ALL)};
+    return true;
+}
+
+void DoorEvents::publish(Event event, uint8_t value, uint8_t data)
+{
+    // nobody listens, nothing to queue
+    if (_subscriberCount == 0)
+        return;
+
+    if (_queued >= DOOR_EVENTS_QUEUE_SIZE)
+    {
+        _dropped++;
+        return;
+    }
+
+    Record &record = _queue[_queued++];
+    record.time = millis();
+    record.event = event;
+    record.value = value;
+    record.data = data;
+    _published[event]++;
+    if (_queued > _maxQueued)
+        _maxQueued = _queued;
+}
+
+void DoorEvents::dispatch()
+{
+    // in publishing order, subscribers see intermediate states of the loop as well
+    for (uint8_t i = 0; i < _queued; i++)
+    {
+        const Record &record = _queue[i];
+        for (uint8_t s = 0; s < _subscriberCount; s++)
+        {
+            if (_subscribers[s].events & (1 << record.event))
+                _subscribers[s].callback(record, _subscribers[s].context);
+        }
+    }
+    _queued = 0;
+}
+
+void DoorEvents::printStatus()
+{
+    logInfoP("Subscribers: %u/%u", _subscriberCount, DOOR_EVENTS_SUBSCRIBERS);
+    logIndentUp();
+    logInfoP("Published: state %lu, mode %lu, sensor %lu, lock %lu", _published[DOOR_STATE], _published[DOOR_MODE], _published[SENSOR], _published[LOCK]);
+    logInfoP("Queue: max %u/%u per loop, dropped %lu", _maxQueued, DOOR_EVENTS_QUEUE_SIZE, _dropped);
+    logIndentDown();
+}
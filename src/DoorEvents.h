@@ -0,0 +1,68 @@
+#pragma once
+#include <Arduino.h>
+#include <cstddef>
+#include <cstdint>
+#include "OpenKNX.h"
+
+#define DOOR_EVENTS_QUEUE_SIZE 16
+#define DOOR_EVENTS_SUBSCRIBERS 4
+
+// DoorEvents passes door events to other modules of the same firmware (e.g.
+// the Logic channels, see main.cpp) without the detour via KOs. Events are
+// queued (KO input between two loops included) and dispatched at the end of
+// the door loop, a subscriber sees everything of a loop iteration before the
+// next module loop runs.
+// Subscribe before openknx.setup(), events published without a subscriber
+// are not queued. Callbacks run in the loop context, they must not block
+// and must not publish themselves. Events beyond DOOR_EVENTS_QUEUE_SIZE per loop are
+// dropped and counted.
+
+class DoorEvents
+{
+  public:
+    enum Event : uint8_t
+    {
+        DOOR_STATE, // value: combined DoorChannel::DoorState, never UNDEFINED
+        DOOR_MODE,  // value: DoorControllerModule::DoorMode
+        SENSOR,     // value: active, data: DoorControllerModule::SensorBit
+        LOCK,       // value: locked (verified), data: DoorLock::Step
+        EVENT_COUNT
+    };
+
+    // subscribe() mask
+    static constexpr uint8_t EVENTS_ALL = (1 << EVENT_COUNT) - 1;
+
+    struct Record
+    {
+        uint32_t time; // millis
+        Event event;
+        uint8_t value;
+        uint8_t data;
+    };
+
+    typedef void (*Callback)(const Record &record, void *context);
+
+    // events: bit per Event, false if all subscriber slots are used
+    bool subscribe(uint8_t events, Callback callback, void *context = nullptr);
+    void publish(Event event, uint8_t value, uint8_t data = 0);
+    void dispatch();
+    void printStatus();
+
+    std::string logPrefix() { return "DoorEvents"; }
+
+  private:
+    struct Subscriber
+    {
+        Callback callback;
+        void *context;
+        uint8_t events;
+    };
+
+    Subscriber _subscribers[DOOR_EVENTS_SUBSCRIBERS] = {};
+    uint8_t _subscriberCount = 0;
+    Record _queue[DOOR_EVENTS_QUEUE_SIZE] = {};
+    uint8_t _queued = 0;
+    uint8_t _maxQueued = 0;
+    uint32_t _published[EVENT_COUNT] = {};
+    uint32_t _dropped = 0;
+};
@@ -0,0 +1,310 @@
+#pragma once
+#include <Arduino.h>
+#include <cstddef>
+#include <cstdint>
+#include "OpenKNX.h"
+
+#define DOOR_FSM_NO_PARENT 0xFF
+#define DOOR_FSM_MAX_TRANSITIONS 4
+#define DOOR_FSM_TRACE_SIZE 16
+
+// DoorFsm is a small table driven hierarchical state machine. States and
+// transitions are constexpr tables of the owner (see DoorChannel.cpp),
+// the engine only keeps the current state, the pending events and a trace.
+//
+// Transitions are evaluated only for raised events, one event bit at a time.
+// The transitions of the current state are searched first, then those of its
+// parents, the first one with a matching event and a passing guard is taken.
+// A transition to the current state is internal (action only, no exit/entry).
+// After a transition FSM_EVENT_ENTRY is raised, so the new state can react to
+// conditions that are already met.
+
+enum DoorFsmEvent : uint8_t
+{
+    FSM_EVENT_DOOR_STATE = 0x01, // state reported by the drive changed
+    FSM_EVENT_SENSOR = 0x02,     // radar or AIR sensor changed
+    FSM_EVENT_SWITCH = 0x04,     // switch trigger received
+    FSM_EVENT_LOCK = 0x08,       // lock changed
+    FSM_EVENT_TIMER = 0x10,      // armed timer expired
+    FSM_EVENT_MODE = 0x20,       // door mode changed
+    FSM_EVENT_ENTRY = 0x40,      // state was entered
+    FSM_EVENT_INTERLOCK = 0x80,  // another door channel changed its state
+};
+
+#define FSM_EVENT_ALL 0xFF
+
+template <typename Owner>
+struct DoorFsmState
+{
+    const char *name;
+    uint8_t parent;         // DOOR_FSM_NO_PARENT for top level states
+    void (Owner::*entry)(); // optional
+    void (Owner::*exit)();  // optional
+};
+
+template <typename Owner>
+struct DoorFsmTransition
+{
+    uint8_t state;
+    uint8_t events;          // events evaluating this transition
+    bool (Owner::*guard)();  // optional
+    void (Owner::*action)(); // optional
+    uint8_t target;
+};
+
+// compile time validation of the tables, use with static_assert
+
+// parents are defined before their children, so the hierarchy has no cycles
+template <typename Owner, size_t N>
+constexpr bool doorFsmStatesValid(const DoorFsmState<Owner> (&states)[N])
+{
+    if (N >= DOOR_FSM_NO_PARENT)
+        return false;
+
+    for (size_t i = 0; i < N; i++)
+    {
+        if (states[i].name == nullptr)
+            return false;
+        if (states[i].parent != DOOR_FSM_NO_PARENT && states[i].parent >= i)
+            return false;
+    }
+    return true;
+}
+
+// transitions are grouped by state in state order and refer to known states and events
+template <typename Owner, size_t N>
+constexpr bool doorFsmTransitionsValid(const DoorFsmTransition<Owner> (&transitions)[N], size_t stateCount)
+{
+    for (size_t i = 0; i < N; i++)
+    {
+        const DoorFsmTransition<Owner> &transition = transitions[i];
+        if (transition.state >= stateCount || transition.target >= stateCount)
+            return false;
+        if (transition.events == 0 || (transition.events & ~FSM_EVENT_ALL) != 0)
+            return false;
+        if (i > 0 && transition.state < transitions[i - 1].state)
+            return false;
+    }
+    return true;
+}
+
+// every state except the initial one is the target of a transition from another state
+template <typename Owner, size_t N>
+constexpr bool doorFsmStatesReachable(const DoorFsmTransition<Owner> (&transitions)[N], size_t stateCount, uint8_t initial)
+{
+    for (size_t state = 0; state < stateCount; state++)
+    {
+        if (state == initial)
+            continue;
+
+        bool reachable = false;
+        for (size_t i = 0; i < N; i++)
+            reachable = reachable || (transitions[i].target == state && transitions[i].state != state);
+
+        if (!reachable)
+            return false;
+    }
+    return true;
+}
+
+// one shot millisecond timer raising FSM_EVENT_TIMER
+class DoorFsmTimer
+{
+  public:
+    void start(uint32_t since, uint32_t delay)
+    {
+        _since = since;
+        _delay = delay;
+        _armed = true;
+    }
+
+    void stop() { _armed = false; }
+
+    bool expired(uint32_t now)
+    {
+        if (!_armed || now - _since < _delay)
+            return false;
+
+        _armed = false;
+        return true;
+    }
+
+  private:
+    uint32_t _since = 0;
+    uint32_t _delay = 0;
+    bool _armed = false;
+};
+
+template <typename Owner>
+class DoorFsm
+{
+  public:
+    struct TraceEntry
+    {
+        uint32_t time; // ms
+        uint8_t from;
+        uint8_t to;
+        uint8_t event;
+    };
+
+    explicit DoorFsm(uint8_t initial) : _state(initial) {}
+
+    inline void raise(uint8_t events) { _pending |= events; }
+    inline void discard() { _pending = 0; }
+    inline bool pending() const { return _pending != 0; }
+    inline uint8_t state() const { return _state; }
+    // the event an action runs for, 0 outside dispatch()
+    // (for FSM_EVENT_ENTRY the one that entered the state)
+    inline uint8_t event() const { return _event; }
+
+    // evaluates all pending events, returns true if the state changed
+    template <size_t S, size_t T>
+    bool dispatch(Owner &owner, const DoorFsmState<Owner> (&states)[S], const DoorFsmTransition<Owner> (&transitions)[T])
+    {
+        uint8_t events = _pending;
+        _pending = 0;
+
+        const uint8_t initial = _state;
+        uint8_t taken = 0;
+        while (events != 0)
+        {
+            // lowest event bit first
+            const uint8_t event = events & (uint8_t)(~events + 1);
+            events &= ~event;
+
+            const DoorFsmTransition<Owner> *transition = find(owner, states, transitions, event);
+            if (transition == nullptr)
+                continue;
+
+            // FSM_EVENT_ENTRY keeps the event that entered the state
+            if (event != FSM_EVENT_ENTRY)
+                _event = event;
+            if (transition->action != nullptr)
+                (owner.*transition->action)();
+
+            if (transition->target == _state)
+                continue;
+
+            record(_state, transition->target, event);
+            logDebugP("%s -> %s (%s)", states[_state].name, states[transition->target].name, eventName(event));
+
+            // exit up to the common parent, then enter down to the target
+            uint8_t state = _state;
+            while (state != DOOR_FSM_NO_PARENT && !contains(states, state, transition->target))
+            {
+                if (states[state].exit != nullptr)
+                    (owner.*states[state].exit)();
+                state = states[state].parent;
+            }
+            enter(owner, states, transition->target, state);
+            _state = transition->target;
+
+            events |= FSM_EVENT_ENTRY;
+
+            // guards flipping back and forth must not block the loop, continue next time
+            if (++taken >= DOOR_FSM_MAX_TRANSITIONS)
+            {
+                _pending |= events;
+                break;
+            }
+        }
+
+        _event = 0;
+        return _state != initial;
+    }
+
+    template <size_t S>
+    void printTrace(const DoorFsmState<Owner> (&states)[S])
+    {
+        const uint32_t now = millis();
+
+        logInfoP("State: %s (transitions: %lu)", states[_state].name, _transitions);
+        logIndentUp();
+        const uint8_t count = _transitions < DOOR_FSM_TRACE_SIZE ? _transitions : DOOR_FSM_TRACE_SIZE;
+        for (uint8_t i = 0; i < count; i++)
+        {
+            const TraceEntry &entry = _trace[(_traceHead + DOOR_FSM_TRACE_SIZE - count + i) % DOOR_FSM_TRACE_SIZE];
+            logInfoP("-%6lu ms: %s -> %s (%s)", now - entry.time, states[entry.from].name, states[entry.to].name, eventName(entry.event));
+        }
+        logIndentDown();
+    }
+
+    static const char *eventName(uint8_t event)
+    {
+        switch (event)
+        {
+            case FSM_EVENT_DOOR_STATE: return "door state";
+            case FSM_EVENT_SENSOR: return "sensor";
+            case FSM_EVENT_SWITCH: return "switch";
+            case FSM_EVENT_LOCK: return "lock";
+            case FSM_EVENT_TIMER: return "timer";
+            case FSM_EVENT_MODE: return "mode";
+            case FSM_EVENT_ENTRY: return "entry";
+            case FSM_EVENT_INTERLOCK: return "interlock";
+            default: return "unknown";
+        }
+    }
+
+    std::string logPrefix() { return "DoorStateMachine"; }
+
+  private:
+    uint8_t _state;
+    uint8_t _pending = FSM_EVENT_ENTRY;
+    uint8_t _event = 0;
+    TraceEntry _trace[DOOR_FSM_TRACE_SIZE] = {};
+    uint8_t _traceHead = 0;
+    uint32_t _transitions = 0;
+
+    template <size_t S, size_t T>
+    const DoorFsmTransition<Owner> *find(Owner &owner, const DoorFsmState<Owner> (&states)[S], const DoorFsmTransition<Owner> (&transitions)[T], uint8_t event)
+    {
+        for (uint8_t state = _state; state != DOOR_FSM_NO_PARENT; state = states[state].parent)
+        {
+            for (size_t i = 0; i < T; i++)
+            {
+                const DoorFsmTransition<Owner> &transition = transitions[i];
+                if (transition.state != state || (transition.events & event) == 0)
+                    continue;
+
+                if (transition.guard == nullptr || (owner.*transition.guard)())
+                    return &transition;
+            }
+        }
+        return nullptr;
+    }
+
+    // true if state is the given child or one of its parents
+    template <size_t S>
+    static bool contains(const DoorFsmState<Owner> (&states)[S], uint8_t state, uint8_t child)
+    {
+        for (; child != DOOR_FSM_NO_PARENT; child = states[child].parent)
+        {
+            if (child == state)
+                return true;
+        }
+        return false;
+    }
+
+    // enters all states from below the common parent down to the target, outermost first
+    template <size_t S>
+    static void enter(Owner &owner, const DoorFsmState<Owner> (&states)[S], uint8_t state, uint8_t common)
+    {
+        if (state == common || state == DOOR_FSM_NO_PARENT)
+            return;
+
+        enter(owner, states, states[state].parent, common);
+        if (states[state].entry != nullptr)
+            (owner.*states[state].entry)();
+    }
+
+    void record(uint8_t from, uint8_t to, uint8_t event)
+    {
+        TraceEntry &entry = _trace[_traceHead];
+        entry.time = millis();
+        entry.from = from;
+        entry.to = to;
+        entry.event = event;
+        _traceHead = (_traceHead + 1) % DOOR_FSM_TRACE_SIZE;
+        _transitions++;
+    }
+};
@@ -0,0 +1,84 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// DoorHistogram keeps min/avg/max and a log2 bucket histogram of uint32
+// samples (cycles or microseconds). Bucket i holds samples in [2^i, 2^(i+1)),
+// the last bucket collects everything above. Percentiles are estimated as the
+// upper bound of the bucket, limited by the real maximum.
+
+class DoorHistogram
+{
+  public:
+    static constexpr uint8_t BUCKETS = 24;
+
+    void record(uint32_t value)
+    {
+        if (_count == 0 || value < _min)
+            _min = value;
+        if (value > _max)
+            _max = value;
+        _sum += value;
+        _count++;
+
+        uint8_t bucket = value == 0 ? 0 : 31 - __builtin_clz(value);
+        if (bucket >= BUCKETS)
+            bucket = BUCKETS - 1;
+
+        // halve all buckets on overflow to keep the distribution, but age old samples
+        if (_buckets[bucket] == UINT16_MAX)
+        {
+            for (uint8_t i = 0; i < BUCKETS; i++)
+                _buckets[i] >>= 1;
+        }
+        _buckets[bucket]++;
+    }
+
+    void reset()
+    {
+        _count = 0;
+        _min = 0;
+        _max = 0;
+        _sum = 0;
+        memset(_buckets, 0, sizeof(_buckets));
+    }
+
+    uint32_t percentile(uint8_t percent) const
+    {
+        uint32_t total = 0;
+        for (uint8_t i = 0; i < BUCKETS; i++)
+            total += _buckets[i];
+
+        if (total == 0)
+            return 0;
+
+        // walk down from the top until the requested tail is covered
+        const uint32_t tail = total - (total * percent) / 100;
+        uint32_t seen = 0;
+        for (int8_t i = BUCKETS - 1; i >= 0; i--)
+        {
+            seen += _buckets[i];
+            if (seen > tail)
+            {
+                const uint32_t upper = (i == BUCKETS - 1) ? _max : (2u << i) - 1;
+                return upper < _max ? upper : _max;
+            }
+        }
+
+        return _max;
+    }
+
+    inline uint32_t count() const { return _count; }
+    inline uint32_t min() const { return _min; }
+    inline uint32_t max() const { return _max; }
+    inline uint32_t avg() const { return _count > 0 ? _sum / _count : 0; }
+    inline uint16_t bucket(uint8_t index) const { return _buckets[index]; }
+
+  private:
+    uint32_t _count = 0;
+    uint32_t _min = 0;
+    uint32_t _max = 0;
+    uint64_t _sum = 0;
+    uint16_t _buckets[BUCKETS] = {};
+};
@@ -0,0 +1,114 @@
+#include "DoorHistory.h"
+#include <LittleFS.h>
+
+void DoorHistory::begin()
+{
+    _ready = LittleFS.begin();
+    if (!_ready)
+    {
+        logErrorP("LittleFS not available, door history disabled");
+        return;
+    }
+
+    if (!LittleFS.exists("/door"))
+        LittleFS.mkdir("/door");
+
+    _lastFlush = delayTimerInit();
+    add(Event::BOOT, 0);
+}
+
+void DoorHistory::loop()
+{
+    if (_buffered == 0)
+        return;
+
+    if (_buffered >= BUFFER_SIZE || delayCheckMillis(_lastFlush, DOOR_HISTORY_FLUSH_INTERVAL))
+        flush();
+}
+
+void DoorHistory::add(Event event, uint8_t value, uint16_t data)
+{
+    if (!_ready)
+        return;
+
+    // the buffer is flushed from loop() before it gets full, this only
+    // happens when flash writes fail
+    if (_buffered >= BUFFER_SIZE)
+    {
+        _dropped++;
+        return;
+    }
+
+    Record &record = _buffer[_buffered++];
+    record.time = millis() / 1000;
+    record.event = event;
+    record.value = value;
+    record.data = data;
+}
+
+void DoorHistory::flush()
+{
+    _lastFlush = delayTimerInit();
+    if (!_ready || _buffered == 0)
+        return;
+
+    File file = LittleFS.open(DOOR_HISTORY_PATH, "a");
+    if (!file)
+    {
+        logErrorP("Could not open %s", DOOR_HISTORY_PATH);
+        return;
+    }
+
+    const size_t length = _buffered * sizeof(Record);
+    const size_t written = file.write(reinterpret_cast<const uint8_t *>(_buffer), length);
+    const size_t fileSize = file.size();
+    file.close();
+
+    if (written != length)
+    {
+        logErrorP("Could not write history (%u of %u bytes)", written, length);
+        return;
+    }
+
+    _written += _buffered;
+    _buffered = 0;
+
+    if (fileSize >= DOOR_HISTORY_FILE_SIZE)
+    {
+        LittleFS.remove(DOOR_HISTORY_PATH_OLD);
+        LittleFS.rename(DOOR_HISTORY_PATH, DOOR_HISTORY_PATH_OLD);
+        logDebugP("History rotated to %s", DOOR_HISTORY_PATH_OLD);
+    }
+}
+
+void DoorHistory::clear()
+{
+    _buffered = 0;
+    _written = 0;
+    _dropped = 0;
+    if (!_ready)
+        return;
+
+    LittleFS.remove(DOOR_HISTORY_PATH);
+    LittleFS.remove(DOOR_HISTORY_PATH_OLD);
+}
+
+void DoorHistory::printStatus()
+{
+    logInfoP("Door history:");
+    logIndentUp();
+    logInfoP("Available: %i", _ready);
+    logInfoP("Buffered records: %u", _buffered);
+    logInfoP("Written records (since boot): %lu", _written);
+    logInfoP("Dropped records: %lu", _dropped);
+    if (_ready)
+    {
+        File file = LittleFS.open(DOOR_HISTORY_PATH, "r");
+        if (file)
+        {
+            logInfoP("File %s: %u bytes", DOOR_HISTORY_PATH, file.size());
+            file.close();
+        }
+    }
+    logIndentDown();
+}
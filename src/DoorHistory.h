@@ -0,0 +1,66 @@
+#pragma once
+#include <Arduino.h>
+#include <cstddef>
+#include <cstdint>
+#include "OpenKNX.h"
+
+#define DOOR_HISTORY_PATH "/door/history.bin"
+#define DOOR_HISTORY_PATH_OLD "/door/history.old.bin"
+#define DOOR_HISTORY_FILE_SIZE 131072
+#define DOOR_HISTORY_FLUSH_INTERVAL 900000
+
+// DoorHistory is an append-only log of door operations kept in LittleFS.
+// Records have a fixed size of 8 bytes and are collected in RAM first, so
+// flash is only written once per buffer (one flash page) or flush interval.
+// LittleFS takes care of wear levelling; when the file is full it is rotated
+// to DOOR_HISTORY_PATH_OLD. Both files can be downloaded via FileTransferModule.
+
+class DoorHistory
+{
+  public:
+    enum class Event : uint8_t
+    {
+        BOOT,
+        DOOR_STATE,
+        DOOR_MODE,
+        LOCK,
+        SENSOR,
+        DRIVE_ERROR
+    };
+
+    enum DriveError : uint8_t
+    {
+        DRIVE_ERROR_SEND_TIMEOUT, // first timeout, link lost
+        DRIVE_ERROR_UNKNOWN_STATE,
+        DRIVE_ERROR_LINK_RESTORED // first response after DRIVE_ERROR_SEND_TIMEOUT
+    };
+
+    struct Record
+    {
+        uint32_t time; // seconds since boot
+        Event event;
+        uint8_t value;
+        uint16_t data; // DOOR_STATE: channel, DRIVE_ERROR: channel << 8 | received state byte
+    };
+
+    static constexpr uint8_t BUFFER_SIZE = 32;
+
+    void begin();
+    void loop();
+    void add(Event event, uint8_t value, uint16_t data = 0);
+    void flush();
+    void clear();
+    void printStatus();
+
+    std::string logPrefix() { return "DoorHistory"; }
+
+  private:
+    static_assert(sizeof(Record) == 8, "DoorHistory record must stay 8 bytes");
+
+    Record _buffer[BUFFER_SIZE] = {};
+    uint8_t _buffered = 0;
+    uint32_t _lastFlush = 0;
+    uint32_t _written = 0;
+    uint32_t _dropped = 0;
+    bool _ready = false;
+};
@@ -0,0 +1,81 @@
+#include "DoorLock.h"
+
+uint8_t DoorLock::request(bool active, uint32_t now)
+{
+    _requested = active;
+    if (!_requested)
+    {
+        // unlocking needs no door movement, it takes effect at once
+        const uint8_t actions = ACTION_STATUS | (_engaged ? ACTION_RELEASE : ACTION_NONE);
+        _step = LOCK_IDLE;
+        _timer.stop();
+        _engaged = false;
+        _locked = false;
+        return actions;
+    }
+
+    if (_engaged && _step == LOCK_IDLE)
+        return ACTION_NONE;
+
+    _attempts = 0;
+    _step = LOCK_CLOSING;
+    _timer.start(now, LOCK_REQUEST_MLD_TIMEOUT);
+    return ACTION_CLOSE;
+}
+
+bool DoorLock::retry(uint32_t now)
+{
+    if (++_attempts < LOCK_ATTEMPTS)
+    {
+        logInfoP("Attempt %u", _attempts + 1);
+        _step = LOCK_CLOSING;
+        _timer.start(now, LOCK_REQUEST_MLD_TIMEOUT);
+        return true;
+    }
+
+    logErrorP("Failed after %u attempts", _attempts);
+    _step = LOCK_FAILED;
+    _locked = false;
+    return false;
+}
+
+uint8_t DoorLock::loop(bool closed, uint32_t now)
+{
+    if (_step == LOCK_IDLE || _step == LOCK_FAILED)
+        return ACTION_NONE;
+
+    const bool timeout = _timer.expired(now);
+    if (_step == LOCK_CLOSING)
+    {
+        if (closed)
+        {
+            _engaged = true;
+            _step = LOCK_ENGAGING;
+            _timer.start(now, LOCK_VERIFY_TIME);
+            return ACTION_ENGAGE;
+        }
+
+        if (!timeout)
+            return ACTION_NONE;
+
+        // blocked by sensors, a mode without state machine or a lost MLD
+        logDebugP("Door not closed, requesting close again");
+        return retry(now) ? ACTION_CLOSE : ACTION_STATUS;
+    }
+
+    // LOCK_ENGAGING: a door that stays closed while the bolt engages is the verification
+    if (!closed)
+    {
+        _engaged = false;
+        logInfoP("Door moved while locking");
+        return ACTION_RELEASE | (retry(now) ? ACTION_CLOSE : ACTION_STATUS);
+    }
+
+    if (!timeout)
+        return ACTION_NONE;
+
+    _step = LOCK_IDLE;
+    _locked = true;
+    logInfoP("Locked");
+    return ACTION_STATUS;
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <Arduino.h>
+#include <cstddef>
+#include <cstdint>
+#include "OpenKNX.h"
+#include "hardware.h"
+#include "DoorFsm.h"
+
+// DoorLock sequences a lock request (KoDOR_DoorLock) without blocking the
+// loop: the leaves close through their state machines (guardLockClose), the
+// sequencer waits for CLOSED, energises LOCK_PIN and verifies the lock by the
+// door staying closed for LOCK_VERIFY_TIME (there is no feedback contact).
+// A door that does not close within LOCK_REQUEST_MLD_TIMEOUT is asked again,
+// a door that moves while the bolt engages is closed again; both count as an
+// attempt, after LOCK_ATTEMPTS the request fails until the next one. request()
+// and loop() only return what the module has to do (Action bits), so the
+// sequence runs without hardware.
+
+class DoorLock
+{
+  public:
+    enum Step : uint8_t
+    {
+        LOCK_IDLE,     // engaged() follows requested()
+        LOCK_CLOSING,  // waiting for all leaves to be CLOSED
+        LOCK_ENGAGING, // LOCK_PIN energised, the door must stay closed
+        LOCK_FAILED    // given up until the next lock request
+    };
+
+    enum Action : uint8_t
+    {
+        ACTION_NONE = 0x00,
+        ACTION_ENGAGE = 0x01,  // energise LOCK_PIN
+        ACTION_RELEASE = 0x02, // release LOCK_PIN
+        ACTION_CLOSE = 0x04,   // ask the state machines to close (FSM_EVENT_LOCK)
+        ACTION_STATUS = 0x08   // report locked() on KoDOR_DoorLockStatus
+    };
+
+    uint8_t request(bool active, uint32_t now);
+    // closed: all leaves report CLOSED
+    uint8_t loop(bool closed, uint32_t now);
+
+    inline Step step() const { return _step; }
+    inline bool requested() const { return _requested; }
+    inline bool engaged() const { return _engaged; }
+    // verified, the value of KoDOR_DoorLockStatus
+    inline bool locked() const { return _locked; }
+    inline uint8_t attempts() const { return _attempts; }
+
+    std::string logPrefix() { return "DoorLock"; }
+
+  private:
+    Step _step = LOCK_IDLE;
+    bool _requested = false;
+    bool _engaged = false;
+    bool _locked = false;
+    uint8_t _attempts = 0;
+    DoorFsmTimer _timer;
+
+    // counts an attempt, false (and LOCK_FAILED) if none is left
+    bool retry(uint32_t now);
+};
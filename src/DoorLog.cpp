@@ -0,0 +1,81 @@
+#include "DoorLog.h"
+#include <cstring>
+
+namespace
+{
+struct DoorLogFormat
+{
+    DoorLogEvent event;
+    const char *text;
+    bool hex;
+};
+
+constexpr DoorLogFormat LOG_FORMATS[] = {
+    {DoorLogEvent::FRAME_RECEIVED, "Door RECEIVED command changed:", true},
+    {DoorLogEvent::FRAME_RECEIVED_LENGTH, "Door RECEIVED command with unexpected length:", true},
+    {DoorLogEvent::FRAME_SENT, "Door SEND command changed:", true},
+    {DoorLogEvent::SEND_TIMEOUT, "Door SEND timeout occurred", false},
+    {DoorLogEvent::UNKNOWN_DOOR_STATE, "Unknown door state received:", true},
+};
+
+const DoorLogFormat *findFormat(DoorLogEvent event)
+{
+    for (const auto &format : LOG_FORMATS)
+    {
+        if (format.event == event)
+            return &format;
+    }
+    return nullptr;
+}
+} // namespace
+
+void DoorEventLog::record(DoorLogEvent event, const uint8_t *data, uint8_t length)
+{
+    Record &record = _records[_head];
+    record.time = micros();
+    record.event = event;
+    record.length = length > DATA_SIZE ? DATA_SIZE : length;
+    if (data != nullptr && record.length > 0)
+        memcpy(record.data, data, record.length);
+
+    _head = (_head + 1) & (SIZE - 1);
+    if (_count < SIZE)
+        _count++;
+    else
+        _overwritten++;
+}
+
+void DoorEventLog::dump()
+{
+    logInfoP("Deferred door log (%u records, %lu overwritten):", _count, _overwritten);
+    logIndentUp();
+
+    const uint16_t start = (_head - _count) & (SIZE - 1);
+    for (uint16_t i = 0; i < _count; i++)
+    {
+        const Record &record = _records[(start + i) & (SIZE - 1)];
+        const DoorLogFormat *format = findFormat(record.event);
+        if (format == nullptr)
+        {
+            logInfoP("%10lu unknown event %u", record.time, static_cast<uint8_t>(record.event));
+            continue;
+        }
+
+        logInfoP("%10lu %s", record.time, format->text);
+        if (format->hex && record.length > 0)
+        {
+            logIndentUp();
+            logHexInfoP(record.data, record.length);
+            logIndentDown();
+        }
+    }
+
+    logIndentDown();
+}
+
+void DoorEventLog::clear()
+{
+    _head = 0;
+    _count = 0;
+    _overwritten = 0;
+}
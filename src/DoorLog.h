@@ -0,0 +1,94 @@
+#pragma once
+#include <Arduino.h>
+#include <cstddef>
+#include <cstdint>
+#include "OpenKNX.h"
+
+// Compile-time log thresholds for the door hot paths (UART handling and
+// frame processing). Everything above the threshold is removed completely,
+// including format strings and argument evaluation.
+#define DOOR_LOG_LEVEL_NONE 0
+#define DOOR_LOG_LEVEL_INFO 1
+#define DOOR_LOG_LEVEL_DEBUG 2
+
+#ifndef DOOR_LOG_LEVEL
+    #define DOOR_LOG_LEVEL DOOR_LOG_LEVEL_INFO
+#endif
+#ifndef DOOR_LOG_LEVEL_MODULE
+    #define DOOR_LOG_LEVEL_MODULE DOOR_LOG_LEVEL
+#endif
+#ifndef DOOR_LOG_LEVEL_SERIAL
+    #define DOOR_LOG_LEVEL_SERIAL DOOR_LOG_LEVEL
+#endif
+
+#if DOOR_LOG_LEVEL_MODULE >= DOOR_LOG_LEVEL_DEBUG
+    #define doorLogDebugP(...) logDebugP(__VA_ARGS__)
+    #define doorLogHexDebugP(text, data, length) \
+        do                                       \
+        {                                        \
+            logDebugP(text);                     \
+            logIndentUp();                       \
+            logHexDebugP(data, length);          \
+            logIndentDown();                     \
+        } while (0)
+#else
+    #define doorLogDebugP(...) \
+        do                     \
+        {                      \
+        } while (0)
+    #define doorLogHexDebugP(text, data, length) \
+        do                                       \
+        {                                        \
+        } while (0)
+#endif
+
+#if DOOR_LOG_LEVEL_SERIAL >= DOOR_LOG_LEVEL_DEBUG
+    #define doorSerialLogDebugP(...) logDebugP(__VA_ARGS__)
+#else
+    #define doorSerialLogDebugP(...) \
+        do                           \
+        {                            \
+        } while (0)
+#endif
+
+enum class DoorLogEvent : uint8_t
+{
+    FRAME_RECEIVED,
+    FRAME_RECEIVED_LENGTH,
+    FRAME_SENT,
+    SEND_TIMEOUT,
+    UNKNOWN_DOOR_STATE
+};
+
+// DoorEventLog is a deferred binary log for the hot paths. Only the event id,
+// a timestamp and the raw arguments are stored in a ring buffer, formatting
+// happens later when the log is dumped from the console.
+class DoorEventLog
+{
+  public:
+    static constexpr uint8_t DATA_SIZE = 10;
+    static constexpr uint8_t SIZE = 64; // must be a power of two
+
+    struct Record
+    {
+        uint32_t time;
+        DoorLogEvent event;
+        uint8_t length;
+        uint8_t data[DATA_SIZE];
+    };
+
+    void record(DoorLogEvent event, const uint8_t *data = nullptr, uint8_t length = 0);
+    inline void record(DoorLogEvent event, uint8_t value) { record(event, &value, 1); }
+    void dump();
+    void clear();
+
+    std::string logPrefix() { return "DoorEventLog"; }
+
+  private:
+    static_assert((SIZE & (SIZE - 1)) == 0, "DoorEventLog size must be a power of two");
+
+    Record _records[SIZE] = {};
+    uint16_t _head = 0;
+    uint16_t _count = 0;
+    uint32_t _overwritten = 0;
+};
@@ -0,0 +1,59 @@
+#include "DoorLoopProfiler.h"
+
+#ifdef DOOR_PERF
+
+void DoorLoopProfiler::reset()
+{
+    for (uint8_t i = 0; i < STAGE_COUNT; i++)
+        _stats[i].reset();
+}
+
+const char *DoorLoopProfiler::stageName(DoorLoopStage stage)
+{
+    switch (stage)
+    {
+        case STAGE_DOOR_SERIAL: return "processDoorSerial";
+        case STAGE_SENSOR_INSIDE_RAD: return "processSensorInsideRadChange";
+        case STAGE_SENSOR_INSIDE_AIR: return "processSensorInsideAirChange";
+        case STAGE_SENSOR_OUTSIDE_RAD: return "processSensorOutsideRadChange";
+        case STAGE_SENSOR_OUTSIDE_AIR: return "processSensorOutsideAirChange";
+        case STAGE_TEST_SIGNAL: return "processTestSignal";
+        case STAGE_PROTECTION: return "checkProtection";
+        case STAGE_DOOR_POWER: return "checkDoorPower";
+        case STAGE_DOOR_STATE: return "updateDoorState";
+        case STAGE_LOCK: return "processLock";
+        case STAGE_STATE_MACHINE: return "processDoorStateMachine";
+        case STAGE_EXT_OUTPUTS: return "updateExtensionOutputs";
+        case STAGE_HISTORY: return "doorHistory.loop";
+        case STAGE_COUNTERS: return "updateCounters";
+        case STAGE_EVENTS: return "doorEvents.dispatch";
+        case STAGE_LOOP_TOTAL: return "loop (total)";
+        default: return "unknown";
+    }
+}
+
+const char *DoorLoopProfiler::stageShortName(DoorLoopStage stage)
+{
+    switch (stage)
+    {
+        case STAGE_DOOR_SERIAL: return "ser";
+        case STAGE_SENSOR_INSIDE_RAD: return "irad";
+        case STAGE_SENSOR_INSIDE_AIR: return "iair";
+        case STAGE_SENSOR_OUTSIDE_RAD: return "orad";
+        case STAGE_SENSOR_OUTSIDE_AIR: return "oair";
+        case STAGE_TEST_SIGNAL: return "tst";
+        case STAGE_PROTECTION: return "prot";
+        case STAGE_DOOR_POWER: return "pwr";
+        case STAGE_DOOR_STATE: return "stat";
+        case STAGE_LOCK: return "lock";
+        case STAGE_STATE_MACHINE: return "fsm";
+        case STAGE_EXT_OUTPUTS: return "ext";
+        case STAGE_HISTORY: return "hist";
+        case STAGE_COUNTERS: return "cnt";
+        case STAGE_EVENTS: return "evt";
+        case STAGE_LOOP_TOTAL: return "all";
+        default: return "?";
+    }
+}
+
+#endif
@@ -0,0 +1,62 @@
+#pragma once
+#include <Arduino.h>
+#include <cstddef>
+#include <cstdint>
+#include "DoorHistogram.h"
+
+// DoorLoopProfiler measures the cost of the individual stages of
+// DoorControllerModule::loop() using the RP2040 cycle counter.
+// It is only compiled in when DOOR_PERF is defined (develop builds),
+// release builds only see the empty DOOR_PERF_MEASURE wrapper.
+
+#ifdef DOOR_PERF
+
+enum DoorLoopStage : uint8_t
+{
+    STAGE_DOOR_SERIAL,
+    STAGE_SENSOR_INSIDE_RAD,
+    STAGE_SENSOR_INSIDE_AIR,
+    STAGE_SENSOR_OUTSIDE_RAD,
+    STAGE_SENSOR_OUTSIDE_AIR,
+    STAGE_TEST_SIGNAL,
+    STAGE_PROTECTION,
+    STAGE_DOOR_POWER,
+    STAGE_DOOR_STATE,
+    STAGE_LOCK,
+    STAGE_STATE_MACHINE,
+    STAGE_EXT_OUTPUTS,
+    STAGE_HISTORY,
+    STAGE_COUNTERS,
+    STAGE_EVENTS,
+    STAGE_LOOP_TOTAL,
+    STAGE_COUNT
+};
+
+class DoorLoopProfiler
+{
+  public:
+    inline uint32_t now() const { return rp2040.getCycleCount(); }
+
+    inline void record(DoorLoopStage stage, uint32_t cycles) { _stats[stage].record(cycles); }
+    void reset();
+    const DoorHistogram &stats(DoorLoopStage stage) const { return _stats[stage]; }
+    static const char *stageName(DoorLoopStage stage);
+    static const char *stageShortName(DoorLoopStage stage);
+
+  private:
+    DoorHistogram _stats[STAGE_COUNT];
+};
+
+    #define DOOR_PERF_MEASURE(stage, call)                              \
+        do                                                              \
+        {                                                               \
+            const uint32_t perfStart = loopProfiler.now();              \
+            call;                                                       \
+            loopProfiler.record(stage, loopProfiler.now() - perfStart); \
+        } while (0)
+
+#else
+
+    #define DOOR_PERF_MEASURE(stage, call) call
+
+#endif
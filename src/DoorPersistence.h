@@ -0,0 +1,143 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Versioned TLV layout of the module's flash area:
+//
+//   [0]      format version (DOOR_FLASH_VERSION)
+//   [1]      length N of the record area
+//   [2..N+1] records: tag (1 byte), length (1 byte), value
+//   [N+2..]  CRC16-CCITT over bytes 0..N+1
+//
+// Readers skip unknown tags (newer firmware wrote them) and keep defaults
+// for missing tags (older firmware did not know them), so fields can be
+// added without breaking saved state in either direction.
+
+#define DOOR_FLASH_VERSION 2
+#define DOOR_FLASH_SIZE 128
+
+enum DoorFlashTag : uint8_t
+{
+    FLASH_TAG_DOOR_MODE = 0x01,
+    FLASH_TAG_COUNTERS = 0x02,
+    FLASH_TAG_TIMING = 0x03,
+    FLASH_TAG_DOOR_DIRECTION = 0x04,
+};
+
+inline uint16_t doorFlashCrc16(const uint8_t *data, size_t length)
+{
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; i++)
+    {
+        crc ^= static_cast<uint16_t>(data[i]) << 8;
+        for (uint8_t bit = 0; bit < 8; bit++)
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+}
+
+class DoorFlashWriter
+{
+  public:
+    DoorFlashWriter()
+    {
+        _buffer[0] = DOOR_FLASH_VERSION;
+    }
+
+    bool add(DoorFlashTag tag, const void *value, uint8_t length)
+    {
+        // keep 2 bytes for the CRC
+        if (_position + 2 + length > DOOR_FLASH_SIZE - 2)
+            return false;
+
+        _buffer[_position++] = tag;
+        _buffer[_position++] = length;
+        memcpy(_buffer + _position, value, length);
+        _position += length;
+        return true;
+    }
+
+    template <typename T>
+    bool add(DoorFlashTag tag, const T &value)
+    {
+        return add(tag, &value, sizeof(T));
+    }
+
+    // finalizes length and CRC, returns the complete block of DOOR_FLASH_SIZE bytes
+    const uint8_t *finish()
+    {
+        _buffer[1] = _position - 2;
+        const uint16_t crc = doorFlashCrc16(_buffer, _position);
+        _buffer[_position] = crc >> 8;
+        _buffer[_position + 1] = crc & 0xFF;
+        return _buffer;
+    }
+
+  private:
+    uint8_t _buffer[DOOR_FLASH_SIZE] = {};
+    uint8_t _position = 2;
+};
+
+class DoorFlashReader
+{
+  public:
+    DoorFlashReader(const uint8_t *data, uint16_t size) : _data(data), _size(size) {}
+
+    bool valid() const
+    {
+        if (_data == nullptr || _size < 4 || _data[0] != DOOR_FLASH_VERSION)
+            return false;
+
+        const uint16_t end = 2 + _data[1];
+        if (end + 2 > _size)
+            return false;
+
+        const uint16_t crc = (_data[end] << 8) | _data[end + 1];
+        return crc == doorFlashCrc16(_data, end);
+    }
+
+    // returns the value of the given tag, nullptr if not present
+    const uint8_t *find(DoorFlashTag tag, uint8_t &length) const
+    {
+        const uint16_t end = 2 + _data[1];
+        uint16_t position = 2;
+        while (position + 2 <= end)
+        {
+            const uint8_t recordTag = _data[position];
+            const uint8_t recordLength = _data[position + 1];
+            if (position + 2 + recordLength > end)
+                break;
+
+            if (recordTag == tag)
+            {
+                length = recordLength;
+                return _data + position + 2;
+            }
+            position += 2 + recordLength;
+        }
+        return nullptr;
+    }
+
+    // copies a value, shorter records (older layout) only fill the beginning
+    bool read(DoorFlashTag tag, void *value, uint8_t size) const
+    {
+        uint8_t length = 0;
+        const uint8_t *record = find(tag, length);
+        if (record == nullptr)
+            return false;
+
+        memcpy(value, record, length < size ? length : size);
+        return true;
+    }
+
+    template <typename T>
+    bool read(DoorFlashTag tag, T &value) const
+    {
+        return read(tag, &value, sizeof(T));
+    }
+
+  private:
+    const uint8_t *_data;
+    uint16_t _size;
+};
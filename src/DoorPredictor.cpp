@@ -0,0 +1,70 @@
+#include "DoorPredictor.h"
+
+void DoorPredictor::radarChanged(Radar radar, bool active, uint32_t timestamp)
+{
+    if (active)
+    {
+        _activeSince[radar] = timestamp;
+    }
+    else if (_active[radar] && passBy(radar) &&
+             timestamp - _activeSince[radar] < DOOR_PREDICTOR_CONFIRM_DELAY)
+    {
+        _skipped[radar]++;
+        logDebugP("Radar %u pulse skipped (pass-by)", radar);
+    }
+
+    _active[radar] = active;
+}
+
+DoorPredictor::Radar DoorPredictor::trigger(uint32_t now) const
+{
+    for (uint8_t i = 0; i < RADAR_COUNT; i++)
+    {
+        const Radar radar = static_cast<Radar>(i);
+        if (!_active[radar])
+            continue;
+
+        if (!passBy(radar) || now - _activeSince[radar] >= DOOR_PREDICTOR_CONFIRM_DELAY)
+            return radar;
+    }
+
+    return RADAR_COUNT;
+}
+
+bool DoorPredictor::preOpenAllowed(Radar radar) const
+{
+    return radar < RADAR_COUNT && !passBy(radar);
+}
+
+void DoorPredictor::cycleOpened(Radar radar)
+{
+    _cycleRadar = radar;
+    _cycleAir = false;
+}
+
+void DoorPredictor::airActive()
+{
+    _cycleAir = true;
+}
+
+void DoorPredictor::cycleClosed()
+{
+    if (_cycleRadar >= RADAR_COUNT)
+        return;
+
+    // ratio += (sample - ratio) / 8
+    uint8_t &ratio = _passByRatio[_cycleRadar];
+    const int16_t sample = _cycleAir ? 0 : 255;
+    ratio += (sample - ratio) / 8;
+
+    _cycleRadar = RADAR_COUNT;
+}
+
+void DoorPredictor::printStatus()
+{
+    logInfoP("Predictive opening:");
+    logIndentUp();
+    for (uint8_t i = 0; i < RADAR_COUNT; i++)
+        logInfoP("Radar %s: pass-by ratio %u/255%s, skipped %lu", i == RADAR_INSIDE ? "inside" : "outside", _passByRatio[i], passBy(static_cast<Radar>(i)) ? " (confirm delay)" : "", _skipped[i]);
+    logIndentDown();
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <Arduino.h>
+#include <cstddef>
+#include <cstdint>
+#include "OpenKNX.h"
+
+#define DOOR_PREDICTOR_CONFIRM_DELAY 300
+#define DOOR_PREDICTOR_PASSBY_RATIO 128
+
+// DoorPredictor decides when a radar trigger should open the door in
+// automatic mode. The radars only provide edges, so instead of a speed it
+// learns per radar how often an opening was useless (nobody crossed the
+// door, i.e. no AIR sensor was active while open). For a radar with mostly
+// useless openings (pass-by traffic) a trigger must stay active for
+// DOOR_PREDICTOR_CONFIRM_DELAY before opening, short pulses are skipped.
+// For all other radars a trigger is allowed to reopen a closing door
+// right away instead of waiting for CLOSED.
+
+class DoorPredictor
+{
+  public:
+    enum Radar : uint8_t
+    {
+        RADAR_INSIDE,
+        RADAR_OUTSIDE,
+        RADAR_COUNT
+    };
+
+    void radarChanged(Radar radar, bool active, uint32_t timestamp);
+    // returns the radar that requests opening at the given time, RADAR_COUNT if none
+    Radar trigger(uint32_t now) const;
+    bool preOpenAllowed(Radar radar) const;
+
+    void cycleOpened(Radar radar);
+    void airActive();
+    void cycleClosed();
+
+    void printStatus();
+    std::string logPrefix() { return "DoorPredictor"; }
+
+  private:
+    uint32_t _activeSince[RADAR_COUNT] = {}; // ms
+    bool _active[RADAR_COUNT] = {};
+    uint8_t _passByRatio[RADAR_COUNT] = {}; // 0..255
+    uint32_t _skipped[RADAR_COUNT] = {};
+    Radar _cycleRadar = RADAR_COUNT;
+    bool _cycleAir = false;
+
+    inline bool passBy(Radar radar) const { return _passByRatio[radar] > DOOR_PREDICTOR_PASSBY_RATIO; }
+};
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "DoorDriver.h"
+
+// Serial protocol of the drive (CS 80 Magneo): 8 byte payloads framed by
+// DoorDriverCs80, the last byte holds the door state.
+
+constexpr uint8_t PAYLOAD_INIT1[]         = {0x00, 0x00, 0x00, 0x52, 0x0B, 0x00, 0x04, 0x06};
+constexpr uint8_t PAYLOAD_INIT2[]         = {0x00, 0x00, 0x00, 0x52, 0x0B, 0x00, 0x04, 0x05};
+constexpr uint8_t PAYLOAD_INIT3[]         = {0x00, 0x00, 0x00, 0x52, 0x0B, 0x00, 0x04, 0x04};
+constexpr uint8_t PAYLOAD_OPEN[]          = {0x00, 0x00, 0x00, 0x52, 0x0B, 0x00, 0x10, 0x04};
+constexpr uint8_t PAYLOAD_CLOSING[]       = {0x00, 0x00, 0x00, 0x52, 0x0B, 0x00, 0x00, 0x01};
+constexpr uint8_t PAYLOAD_CLOSING_PRE1[]  = {0x00, 0x00, 0x00, 0x52, 0x0B, 0x00, 0x12, 0x04}; // radar?
+constexpr uint8_t PAYLOAD_CLOSING_PRE2[]  = {0x00, 0x00, 0x00, 0x52, 0x0B, 0x00, 0x14, 0x04}; // infrared?
+constexpr uint8_t PAYLOAD_CLOSED[]        = {0x00, 0x00, 0x00, 0x52, 0x0B, 0x00, 0x00, 0x03};
+constexpr uint8_t PAYLOAD_OPENING[]       = {0x00, 0x00, 0x00, 0x52, 0x0B, 0x00, 0x10, 0x00};
+constexpr uint8_t PAYLOAD_OPENING_PRE1[]  = {0x00, 0x00, 0x00, 0x52, 0x0B, 0x00, 0x12, 0x03};
+
+// last byte is door state
+#define DOOR_STATE_OPEN       0x04
+#define DOOR_STATE_CLOSED     0x03
+#define DOOR_STATE_CLOSING    0x01
+#define DOOR_STATE_OPENING    0x00
+
+// second last byte is trigger reason
+#define DOOR_TRIGGER_RADAR    0x12
+#define DOOR_TRIGGER_INFRARED 0x14
+
+constexpr size_t DOOR_CS80_PAYLOAD_SIZE = sizeof(PAYLOAD_INIT1);
+
+static_assert(DOOR_CS80_PAYLOAD_SIZE == sizeof(PAYLOAD_INIT1), "Door payload size mismatch");
+static_assert(DOOR_CS80_PAYLOAD_SIZE == sizeof(PAYLOAD_INIT2), "Door payload size mismatch");
+static_assert(DOOR_CS80_PAYLOAD_SIZE == sizeof(PAYLOAD_INIT3), "Door payload size mismatch");
+static_assert(DOOR_CS80_PAYLOAD_SIZE == sizeof(PAYLOAD_OPEN), "Door payload size mismatch");
+static_assert(DOOR_CS80_PAYLOAD_SIZE == sizeof(PAYLOAD_CLOSING), "Door payload size mismatch");
+static_assert(DOOR_CS80_PAYLOAD_SIZE == sizeof(PAYLOAD_CLOSED), "Door payload size mismatch");
+static_assert(DOOR_CS80_PAYLOAD_SIZE == sizeof(PAYLOAD_OPENING), "Door payload size mismatch");
+
+// Define prefix message sequences here. Each entry is transmitted once (in order)
+// before the final payload is sent continuously again.
+constexpr const uint8_t *PREFIX_CLOSING[] = {PAYLOAD_CLOSING_PRE1, PAYLOAD_CLOSING_PRE2};
+constexpr const uint8_t *PREFIX_OPENING[] = {PAYLOAD_OPENING_PRE1};
+
+constexpr DoorCommandDefinition COMMAND_INIT1{PAYLOAD_INIT1, 0u, nullptr};
+constexpr DoorCommandDefinition COMMAND_INIT2{PAYLOAD_INIT2, 0u, nullptr};
+constexpr DoorCommandDefinition COMMAND_INIT3{PAYLOAD_INIT3, 0u, nullptr};
+constexpr DoorCommandDefinition COMMAND_OPEN{PAYLOAD_OPEN, 0u, nullptr};
+constexpr DoorCommandDefinition COMMAND_CLOSING{PAYLOAD_CLOSING, arrayCount(PREFIX_CLOSING), PREFIX_CLOSING};
+constexpr DoorCommandDefinition COMMAND_CLOSED{PAYLOAD_CLOSED, 0u, nullptr};
+constexpr DoorCommandDefinition COMMAND_OPENING{PAYLOAD_OPENING, arrayCount(PREFIX_OPENING), PREFIX_OPENING};
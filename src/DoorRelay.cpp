@@ -0,0 +1,78 @@
+#include "DoorRelay.h"
+
+void DoorRelay::begin()
+{
+    for (Contact &contact : _contacts)
+        openknx.gpio.pinMode(contact.pin, OUTPUT, true, !contact.activeLevel);
+
+    _enabled = true;
+    logInfoP("Contact interface enabled, door state modelled without position feedback");
+}
+
+void DoorRelay::pulse(Output output)
+{
+    if (!_enabled)
+        return;
+
+    Contact &contact = _contacts[output];
+    if (contact.alarm > 0)
+        cancel_alarm(contact.alarm);
+
+    digitalWrite(contact.pin, contact.activeLevel);
+    contact.active = true;
+    _pulses++;
+
+    contact.alarm = add_alarm_in_ms(MAIN_SIGNAL_LENGTH, &DoorRelay::endPulse, &contact, true);
+    if (contact.alarm < 0)
+    {
+        // no free alarm, a stuck contact would keep triggering the drive
+        _alarmErrors++;
+        endPulse(0, &contact);
+        logErrorP("No alarm for impulse %u", output);
+    }
+}
+
+int64_t DoorRelay::endPulse(alarm_id_t id, void *contact)
+{
+    // timer interrupt
+    Contact *target = static_cast<Contact *>(contact);
+    digitalWrite(target->pin, !target->activeLevel);
+    target->active = false;
+    target->alarm = 0;
+    return 0;
+}
+
+void DoorRelay::set(Output output, bool active)
+{
+    if (!_enabled)
+        return;
+
+    Contact &contact = _contacts[output];
+    digitalWrite(contact.pin, active ? contact.activeLevel : !contact.activeLevel);
+    contact.active = active;
+}
+
+void DoorRelay::moved(bool open, uint32_t now)
+{
+    _state = open ? DoorDriverState::OPENING : DoorDriverState::CLOSING;
+    _movingSince = now;
+}
+
+DoorDriverState DoorRelay::state(uint32_t now)
+{
+    if (_state == DoorDriverState::OPENING && now - _movingSince >= MAIN_RELAY_OPENING_TIME)
+        _state = DoorDriverState::OPEN;
+    else if (_state == DoorDriverState::CLOSING && now - _movingSince >= MAIN_RELAY_CLOSING_TIME)
+        _state = DoorDriverState::CLOSED;
+
+    return _state;
+}
+
+void DoorRelay::printStatus()
+{
+    logInfoP("Contact interface: %s", _enabled ? "enabled" : "disabled");
+    logIndentUp();
+    logInfoP("MLD %u, LCK %u, HSK %u, NSK %u", _contacts[MLD].active, _contacts[LCK].active, _contacts[HSK].active, _contacts[NSK].active);
+    logInfoP("Impulses: %lu, alarm errors: %lu", _pulses, _alarmErrors);
+    logIndentDown();
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <Arduino.h>
+#include <cstddef>
+#include <cstdint>
+#include <pico/time.h>
+#include "OpenKNX.h"
+#include "hardware.h"
+#include "DoorDriver.h"
+
+// DoorRelay drives the door through its contact inputs instead of the
+// serial link (ETS "Antriebsanschluss"): MLD (impulse, opens a closed door
+// and closes an open one), LCK (lock impulse), HSK/NSK (closing edge safety,
+// level). Impulses last MAIN_SIGNAL_LENGTH and are ended by a pico SDK alarm
+// (hardware timer interrupt), so their length does not depend on loop
+// latency and the loop does not poll them.
+// The contacts do not report the door state, it is modelled from the
+// impulses and MAIN_RELAY_OPENING_TIME/MAIN_RELAY_CLOSING_TIME, assuming
+// CLOSED at startup. The lock only verifies this modelled closed position
+// and the airlock interlock relies on it, both log a warning when used with
+// the contact interface. There is one set of contacts, it replaces the
+// serial link of channel 0.
+
+class DoorRelay
+{
+  public:
+    enum Output : uint8_t
+    {
+        MLD,
+        LCK,
+        HSK,
+        NSK,
+        OUTPUT_COUNT
+    };
+
+    void begin();
+    inline bool enabled() const { return _enabled; }
+
+    // impulse outputs (MLD, LCK), a running impulse is restarted
+    void pulse(Output output);
+    // level outputs (HSK, NSK)
+    void set(Output output, bool active);
+    inline bool active(Output output) const { return _contacts[output].active; }
+
+    // door movement caused by an MLD impulse
+    void moved(bool open, uint32_t now);
+    DoorDriverState state(uint32_t now);
+
+    void printStatus();
+    std::string logPrefix() { return "DoorRelay"; }
+
+  private:
+    struct Contact
+    {
+        uint8_t pin;
+        uint8_t activeLevel;
+        volatile bool active;
+        volatile alarm_id_t alarm;
+    };
+
+    Contact _contacts[OUTPUT_COUNT] = {
+        {MAIN_MLD_PIN, MAIN_MLD_ACTIVE, false, 0},
+        {MAIN_LCK_PIN, MAIN_LCK_ACTIVE, false, 0},
+        {MAIN_HSK_PIN, MAIN_HSK_NSK_ACTIVE, false, 0},
+        {MAIN_NSK_PIN, MAIN_HSK_NSK_ACTIVE, false, 0},
+    };
+    bool _enabled = false;
+    DoorDriverState _state = DoorDriverState::CLOSED; // assumed at startup
+    uint32_t _movingSince = 0;
+    uint32_t _pulses = 0;
+    uint32_t _alarmErrors = 0;
+
+    static int64_t endPulse(alarm_id_t id, void *contact);
+};
@@ -0,0 +1,306 @@
+#include "DoorScript.h"
+#include "DoorConsole.h"
+#include <cstring>
+
+namespace
+{
+struct CommandLookupEntry
+{
+    const char *name;
+    DoorCommandId command;
+};
+
+constexpr CommandLookupEntry COMMAND_LOOKUP[] = {
+    {"it1", DOOR_COMMAND_INIT1},
+    {"it2", DOOR_COMMAND_INIT2},
+    {"it3", DOOR_COMMAND_INIT3},
+    {"opg", DOOR_COMMAND_OPENING},
+    {"opn", DOOR_COMMAND_OPEN},
+    {"clg", DOOR_COMMAND_CLOSING},
+    {"cls", DOOR_COMMAND_CLOSED},
+};
+
+constexpr DoorLookup BUILTIN_COMMANDS(COMMAND_LOOKUP);
+static_assert(BUILTIN_COMMANDS.valid(), "Door console: ambiguous command tokens");
+
+int8_t hexDigit(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+} // namespace
+
+void DoorScript::begin(const DoorCommandTable &commands, PrefixesInUse prefixesInUse)
+{
+    _commands = &commands;
+    _prefixesInUse = prefixesInUse;
+}
+
+const DoorCommandDefinition *DoorScript::resolve(std::string_view command)
+{
+    const CommandLookupEntry *entry = BUILTIN_COMMANDS.find(command);
+    if (entry != nullptr)
+        return &_commands->command(entry->command);
+
+    Sequence *sequence = findSequence(command);
+    if (sequence != nullptr)
+        return &sequence->definition;
+
+    // no prefixes and DoorChannel copies the final payload, so no channel refers to the raw slot
+    if (!parsePayload(command, _raw.payloads[0]))
+        return nullptr;
+
+    _raw.definition = {_raw.payloads[0], 0u, nullptr};
+    return &_raw.definition;
+}
+
+bool DoorScript::define(std::string_view name, std::string_view payloads)
+{
+    if (name.empty() || name.size() >= DOOR_SCRIPT_NAME_SIZE || BUILTIN_COMMANDS.find(name) != nullptr)
+        return false;
+
+    for (const char c : name)
+    {
+        if (!isalnum(c) && c != '_')
+            return false;
+    }
+
+    uint8_t parsed[DOOR_SCRIPT_PAYLOAD_MAX][DOOR_PAYLOAD_SIZE];
+    size_t count = 0;
+    for (std::string_view word = nextWord(payloads); !word.empty(); word = nextWord(payloads))
+    {
+        if (count == DOOR_SCRIPT_PAYLOAD_MAX || !parsePayload(word, parsed[count]))
+            return false;
+        count++;
+    }
+
+    Sequence *sequence = findSequence(name);
+    if (sequence != nullptr && sequence->definition.prefixCount > 0 && _prefixesInUse(sequence->prefixes))
+    {
+        logInfoP("Sequence %s is being sent", sequence->name);
+        return false;
+    }
+
+    if (count == 0)
+    {
+        // delete
+        if (sequence == nullptr)
+            return false;
+        sequence->name[0] = '\0';
+        return true;
+    }
+
+    for (size_t i = 0; sequence == nullptr && i < DOOR_SCRIPT_SEQUENCE_COUNT; i++)
+    {
+        if (_sequences[i].name[0] == '\0')
+            sequence = &_sequences[i];
+    }
+
+    if (sequence == nullptr)
+    {
+        logInfoP("No free sequence, %u at most", DOOR_SCRIPT_SEQUENCE_COUNT);
+        return false;
+    }
+
+    memcpy(sequence->name, name.data(), name.size());
+    sequence->name[name.size()] = '\0';
+    memcpy(sequence->payloads, parsed, count * DOOR_PAYLOAD_SIZE);
+    for (size_t i = 0; i + 1 < count; i++)
+        sequence->prefixes[i] = sequence->payloads[i];
+    sequence->definition = {sequence->payloads[count - 1], count - 1, count > 1 ? sequence->prefixes : nullptr};
+    return true;
+}
+
+void DoorScript::printSequences()
+{
+    logInfoP("Sequences:");
+    logIndentUp();
+    for (const Sequence &sequence : _sequences)
+    {
+        if (sequence.name[0] == '\0')
+            continue;
+
+        logInfoP("%s: %u prefixes", sequence.name, sequence.definition.prefixCount);
+        for (size_t i = 0; i < sequence.definition.prefixCount; i++)
+            logHexInfoP(sequence.prefixes[i], DOOR_PAYLOAD_SIZE);
+        logHexInfoP(sequence.definition.finalPayload, DOOR_PAYLOAD_SIZE);
+    }
+    logIndentDown();
+
+    if (_running)
+        logInfoP("Script running, line %u", _line);
+}
+
+bool DoorScript::start(std::string_view path)
+{
+    stop();
+
+    char fileName[DOOR_SCRIPT_LINE_SIZE];
+    if (path.size() >= sizeof(fileName))
+        return false;
+    memcpy(fileName, path.data(), path.size());
+    fileName[path.size()] = '\0';
+
+    _file = LittleFS.open(fileName, "r");
+    if (!_file)
+    {
+        logErrorP("Script %s not found", fileName);
+        return false;
+    }
+
+    logInfoP("Script %s started", fileName);
+    _running = true;
+    _line = 0;
+    // an empty script finishes at once, that is no error
+    readStep();
+    return true;
+}
+
+void DoorScript::stop()
+{
+    if (_running)
+        stopScript("stopped");
+}
+
+void DoorScript::stopScript(const char *reason)
+{
+    logInfoP("Script %s at line %u", reason, _line);
+    _file.close();
+    _running = false;
+    _stepPending = false;
+}
+
+const DoorCommandDefinition *DoorScript::loop()
+{
+    if (!_running)
+        return nullptr;
+
+    // read once the sequence just sent is through, the step may redefine it
+    if (_stepPending)
+    {
+        if (_prefixesInUse(nullptr))
+            return nullptr;
+
+        _stepPending = false;
+        readStep();
+        return nullptr;
+    }
+
+    if (!delayCheckMillis(_stepStart, _wait))
+        return nullptr;
+
+    const DoorCommandDefinition *definition = resolve(_command);
+    if (definition == nullptr)
+    {
+        stopScript("unknown command");
+        return nullptr;
+    }
+
+    logDebugP("Line %u: send %s", _line, _command);
+    _stepPending = true;
+    return definition;
+}
+
+bool DoorScript::readStep()
+{
+    char line[DOOR_SCRIPT_LINE_SIZE];
+    while (_file.available() > 0)
+    {
+        const size_t length = _file.readBytesUntil('\n', line, sizeof(line));
+        _line++;
+        if (length == sizeof(line))
+        {
+            stopScript("line too long");
+            return false;
+        }
+
+        std::string_view text(line, length);
+        const std::string_view word = nextWord(text);
+        if (word.empty() || word[0] == '#')
+            continue;
+
+        if (word == "def")
+        {
+            const std::string_view name = nextWord(text);
+            if (!define(name, text))
+            {
+                stopScript("invalid sequence");
+                return false;
+            }
+            continue;
+        }
+
+        uint32_t wait = 0;
+        for (const char c : word)
+        {
+            if (c < '0' || c > '9' || wait > DOOR_SCRIPT_WAIT_MAX)
+            {
+                stopScript("invalid wait time");
+                return false;
+            }
+            wait = wait * 10 + (c - '0');
+        }
+
+        const std::string_view command = nextWord(text);
+        if (command.empty() || !nextWord(text).empty() || wait > DOOR_SCRIPT_WAIT_MAX)
+        {
+            stopScript("invalid step");
+            return false;
+        }
+
+        memcpy(_command, command.data(), command.size());
+        _command[command.size()] = '\0';
+        _wait = wait;
+        _stepStart = delayTimerInit();
+        return true;
+    }
+
+    stopScript("finished");
+    return false;
+}
+
+DoorScript::Sequence *DoorScript::findSequence(std::string_view name)
+{
+    for (Sequence &sequence : _sequences)
+    {
+        if (sequence.name[0] != '\0' && name == sequence.name)
+            return &sequence;
+    }
+    return nullptr;
+}
+
+bool DoorScript::parsePayload(std::string_view hex, uint8_t *payload)
+{
+    if (hex.size() != DOOR_PAYLOAD_SIZE * 2)
+        return false;
+
+    for (size_t i = 0; i < DOOR_PAYLOAD_SIZE; i++)
+    {
+        const int8_t high = hexDigit(hex[i * 2]);
+        const int8_t low = hexDigit(hex[i * 2 + 1]);
+        if (high < 0 || low < 0)
+            return false;
+        payload[i] = high << 4 | low;
+    }
+    return true;
+}
+
+std::string_view DoorScript::nextWord(std::string_view &text)
+{
+    // blanks and the \r of uploaded files separate words
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t' || text.front() == '\r'))
+        text.remove_prefix(1);
+
+    size_t length = 0;
+    while (length < text.size() && text[length] != ' ' && text[length] != '\t' && text[length] != '\r')
+        length++;
+
+    const std::string_view word = text.substr(0, length);
+    text.remove_prefix(length);
+    return word;
+}
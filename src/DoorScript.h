@@ -0,0 +1,84 @@
+#pragma once
+#include <Arduino.h>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <LittleFS.h>
+#include "OpenKNX.h"
+#include "DoorDrivers.h"
+#include "DoorCommandTable.h"
+
+#define DOOR_SCRIPT_SEQUENCE_COUNT 8
+#define DOOR_SCRIPT_NAME_SIZE 8     // including terminator
+#define DOOR_SCRIPT_PAYLOAD_MAX 4   // prefixes + final payload
+#define DOOR_SCRIPT_LINE_SIZE 128
+#define DOOR_SCRIPT_WAIT_MAX 600000 // ms
+
+// DoorScript is the console side of protocol exploration. It resolves
+// what "dc send" accepts into a DoorCommandDefinition: a built-in token
+// (it1 ... cls, see DoorCommandTable), the name of a sequence defined at runtime or a raw payload
+// of DOOR_PAYLOAD_SIZE bytes in hex. Sequences work like PREFIX_CLOSING:
+// all but the last payload are sent once, the last one is repeated. They
+// live in a fixed pool, DoorChannel copies the final payload and sends the
+// prefixes from the pool: a sequence whose prefixes are still being sent
+// cannot be redefined or deleted, a script waits for them before its next
+// step. Raw payloads have no prefixes, their slot is reused.
+//
+// A script is a text file in LittleFS (e.g. uploaded via FileTransferModule)
+// with one step per line, run without blocking the loop:
+//   # comment
+//   def <name> <hex> [<hex> ...]   define a sequence
+//   <wait ms> <command>            wait, then send like "dc send <command>"
+// The command is handed back by loop() and goes through the same scheduled
+// send path as the state machine (DoorChannel::setDoorCommand).
+
+class DoorScript
+{
+  public:
+    // true while a channel sends the prefixes, nullptr: any prefixes
+    typedef bool (*PrefixesInUse)(const uint8_t *const *prefixes);
+
+    void begin(const DoorCommandTable &commands, PrefixesInUse prefixesInUse);
+    const DoorCommandDefinition *resolve(std::string_view command);
+    // no payloads deletes the sequence
+    bool define(std::string_view name, std::string_view payloads);
+    void printSequences();
+
+    // false if the script cannot be opened
+    bool start(std::string_view path);
+    void stop();
+    inline bool running() const { return _running; }
+    // command due now, nullptr otherwise
+    const DoorCommandDefinition *loop();
+
+    std::string logPrefix() { return "DoorScript"; }
+
+  private:
+    struct Sequence
+    {
+        char name[DOOR_SCRIPT_NAME_SIZE];
+        uint8_t payloads[DOOR_SCRIPT_PAYLOAD_MAX][DOOR_PAYLOAD_SIZE];
+        const uint8_t *prefixes[DOOR_SCRIPT_PAYLOAD_MAX - 1];
+        DoorCommandDefinition definition;
+    };
+
+    const DoorCommandTable *_commands = nullptr;
+    PrefixesInUse _prefixesInUse = nullptr;
+    Sequence _sequences[DOOR_SCRIPT_SEQUENCE_COUNT] = {};
+    Sequence _raw = {};
+
+    File _file;
+    bool _running = false;
+    bool _stepPending = false;
+    uint32_t _stepStart = 0;
+    uint32_t _wait = 0;
+    uint16_t _line = 0;
+    char _command[DOOR_SCRIPT_LINE_SIZE] = {};
+
+    Sequence *findSequence(std::string_view name);
+    bool readStep();
+    void stopScript(const char *reason);
+
+    static bool parsePayload(std::string_view hex, uint8_t *payload);
+    static std::string_view nextWord(std::string_view &text);
+};
@@ -0,0 +1,191 @@
+#include "DoorSensorTest.h"
+
+void DoorSensorTest::begin()
+{
+    _enabled = true;
+    logDebugP("Sensor test enabled");
+}
+
+void DoorSensorTest::request(uint8_t sensors)
+{
+    if (!_enabled)
+        return;
+
+    // a running cycle is finished first, the next one starts afterwards
+    _sensors = sensors & ((1 << SENSOR_COUNT) - 1);
+    _requested = true;
+    _passed = false;
+    _lastFailure = micros() - DOOR_SENSOR_TEST_RETRY * 1000;
+}
+
+void DoorSensorTest::setOutput(bool active)
+{
+    digitalWrite(SENSOR_TST_PIN, active ? SENSOR_TST_ACTIVE : !SENSOR_TST_ACTIVE);
+}
+
+bool DoorSensorTest::loop(uint32_t now, const bool active[SENSOR_COUNT], const uint32_t changedAt[SENSOR_COUNT])
+{
+    switch (_phase)
+    {
+        case Phase::IDLE:
+            if (!_requested)
+                return false;
+
+            if (_sensors == 0)
+            {
+                _requested = false;
+                _passed = true;
+                return true;
+            }
+
+            if (!_passed && now - _lastFailure < DOOR_SENSOR_TEST_RETRY * 1000)
+                return false;
+
+            // a detecting sensor cannot show a response, the door does not close anyway
+            for (uint8_t i = 0; i < SENSOR_COUNT; i++)
+            {
+                if ((_sensors & (1 << i)) && active[i])
+                    return false;
+            }
+
+            setOutput(true);
+            _phase = Phase::TESTING;
+            _phaseStart = now;
+            _responded = 0;
+            _errors = 0;
+            _cycles++;
+            return true;
+
+        case Phase::TESTING:
+            for (uint8_t i = 0; i < SENSOR_COUNT; i++)
+            {
+                const uint8_t bit = 1 << i;
+                // edge after the test output was activated
+                if (!(_sensors & bit) || (_responded & bit) || !active[i] || (int32_t)(changedAt[i] - _phaseStart) < 0)
+                    continue;
+
+                const uint32_t response = changedAt[i] - _phaseStart;
+                _responseTime[i].record(response);
+                _responded |= bit;
+                if (response < SENSOR_TST_RESPONSE_MIN)
+                {
+                    // faster than the sensor can evaluate the test, e.g. a shorted output
+                    _early[i]++;
+                    _errors |= bit;
+                }
+            }
+
+            if (_responded != _sensors && now - _phaseStart <= SENSOR_TST_RESPONSE_MAX)
+                return false;
+
+            for (uint8_t i = 0; i < SENSOR_COUNT; i++)
+            {
+                const uint8_t bit = 1 << i;
+                if ((_sensors & bit) && !(_responded & bit))
+                {
+                    _missing[i]++;
+                    _errors |= bit;
+                }
+                // seen by the loop after the window, the edge itself was too late
+                else if ((_sensors & bit) && changedAt[i] - _phaseStart > SENSOR_TST_RESPONSE_MAX)
+                {
+                    _missing[i]++;
+                    _errors |= bit;
+                }
+            }
+
+            setOutput(false);
+            _phase = Phase::RELEASING;
+            _phaseStart = now;
+            return true;
+
+        case Phase::RELEASING:
+        {
+            uint8_t released = 0;
+            for (uint8_t i = 0; i < SENSOR_COUNT; i++)
+            {
+                if ((_sensors & (1 << i)) && !active[i])
+                    released |= 1 << i;
+            }
+
+            if (released != _sensors && now - _phaseStart <= SENSOR_TST_RESPONSE_MAX)
+                return false;
+
+            for (uint8_t i = 0; i < SENSOR_COUNT; i++)
+            {
+                const uint8_t bit = 1 << i;
+                if (!(_sensors & bit))
+                    continue;
+
+                if (released & bit)
+                {
+                    // sensors that did not respond have no release edge
+                    if ((_responded & bit) && (int32_t)(changedAt[i] - _phaseStart) >= 0)
+                        _releaseTime[i].record(changedAt[i] - _phaseStart);
+                }
+                else
+                {
+                    _stuck[i]++;
+                    _errors |= bit;
+                }
+            }
+
+            finish(now);
+            return true;
+        }
+    }
+    return false;
+}
+
+void DoorSensorTest::finish(uint32_t now)
+{
+    _phase = Phase::IDLE;
+    if (_errors == 0)
+    {
+        _requested = false;
+        _passed = true;
+        logDebugP("Passed");
+        return;
+    }
+
+    // stays requested and is repeated
+    _passed = false;
+    _failures++;
+    _lastFailure = now;
+    logErrorP("Failed, sensors 0x%02X", _errors);
+}
+
+void DoorSensorTest::resetStatistics()
+{
+    for (uint8_t i = 0; i < SENSOR_COUNT; i++)
+    {
+        _responseTime[i].reset();
+        _releaseTime[i].reset();
+        _early[i] = 0;
+        _missing[i] = 0;
+        _stuck[i] = 0;
+    }
+    _cycles = 0;
+    _failures = 0;
+}
+
+void DoorSensorTest::printStatus()
+{
+    static constexpr const char *SENSOR_NAMES[SENSOR_COUNT] = {"inside", "outside"};
+
+    logInfoP("Sensor test: %s", !_enabled ? "disabled" : running() ? "running" : _requested ? "pending" : _passed ? "passed" : "idle");
+    logIndentUp();
+    logInfoP("Window: %lu..%lu us", (uint32_t)SENSOR_TST_RESPONSE_MIN, (uint32_t)SENSOR_TST_RESPONSE_MAX);
+    logInfoP("Cycles: %lu, failed: %lu", _cycles, _failures);
+    for (uint8_t i = 0; i < SENSOR_COUNT; i++)
+    {
+        const DoorHistogram &response = _responseTime[i];
+        const DoorHistogram &release = _releaseTime[i];
+        logInfoP("AIR %s: response min/avg/max/p95 %lu/%lu/%lu/%lu us, release avg/max %lu/%lu us", SENSOR_NAMES[i],
+                 response.min(), response.avg(), response.max(), response.percentile(95), release.avg(), release.max());
+        logIndentUp();
+        logInfoP("Too early: %lu, missing: %lu, stuck: %lu", _early[i], _missing[i], _stuck[i]);
+        logIndentDown();
+    }
+    logIndentDown();
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <Arduino.h>
+#include <cstddef>
+#include <cstdint>
+#include "OpenKNX.h"
+#include "hardware.h"
+#include "DoorHistogram.h"
+
+#define DOOR_SENSOR_TEST_RETRY 1000 // ms after a failed cycle
+
+// DoorSensorTest checks the closing edge safety sensors (e.g. BEA IXIO-ST)
+// through their test input before the door closes (ETS "Sensortest vor dem
+// Schließen"). A cycle activates SENSOR_TST_PIN, every tested sensor must
+// report detection within SENSOR_TST_RESPONSE_MIN..MAX (us) and release it
+// within SENSOR_TST_RESPONSE_MAX after the test input is released. The edges
+// are timestamped by the sensor ISRs, so the measured response time does not
+// depend on when the loop looks at it.
+// The test is requested when the door opens and runs during the hold time,
+// the result is known when the door would close and closing is not delayed.
+// A failed cycle keeps the door open and is repeated after
+// DOOR_SENSOR_TEST_RETRY. While a cycle runs, the sensor outputs are test
+// responses and no detections.
+
+class DoorSensorTest
+{
+  public:
+    enum Sensor : uint8_t
+    {
+        INSIDE,
+        OUTSIDE,
+        SENSOR_COUNT
+    };
+
+    void begin();
+    inline bool enabled() const { return _enabled; }
+
+    // sensors: bit per Sensor, see DoorControllerModule::sensorTestSensors()
+    void request(uint8_t sensors);
+    // closing allowed, always true if disabled
+    inline bool passed() const { return !_enabled || (!_requested && _passed); }
+    inline bool running() const { return _phase != Phase::IDLE; }
+    inline bool testActive() const { return _phase == Phase::TESTING; }
+
+    // active/changedAt: sensor outputs and their last edge (micros) from the ISRs
+    // returns true if the test output or the result changed
+    bool loop(uint32_t now, const bool active[SENSOR_COUNT], const uint32_t changedAt[SENSOR_COUNT]);
+
+    void printStatus();
+    void resetStatistics();
+    std::string logPrefix() { return "DoorSensorTest"; }
+
+  private:
+    enum class Phase : uint8_t
+    {
+        IDLE,
+        TESTING,  // TST active, waiting for detection
+        RELEASING // TST released, waiting for the sensors to release
+    };
+
+    bool _enabled = false;
+    bool _requested = false;
+    bool _passed = false;
+    Phase _phase = Phase::IDLE;
+    uint8_t _sensors = 0;
+    uint8_t _responded = 0;
+    uint8_t _errors = 0;
+    uint32_t _phaseStart = 0;  // us
+    uint32_t _lastFailure = 0; // us
+
+    DoorHistogram _responseTime[SENSOR_COUNT]; // us
+    DoorHistogram _releaseTime[SENSOR_COUNT];  // us
+    uint32_t _cycles = 0;
+    uint32_t _failures = 0;
+    uint32_t _early[SENSOR_COUNT] = {};
+    uint32_t _missing[SENSOR_COUNT] = {};
+    uint32_t _stuck[SENSOR_COUNT] = {};
+
+    void setOutput(bool active);
+    void finish(uint32_t now);
+};
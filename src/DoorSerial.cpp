@@ -1,12 +1,11 @@
 #include "DoorSerial.h"
 
 #include <algorithm>
+#include <cstring>
 #include <utility>
 #include <cstdio>
 
-DoorSerial::DoorSerial()
-    : rxState(RxState::Idle),
-      computedChecksum(0) {}
+DoorSerial::DoorSerial() {}
 
 DoorSerial::~DoorSerial() {
     end();
@@ -17,29 +16,47 @@ std::string DoorSerial::logPrefix()
     return "DoorSerial";
 }
 
-void DoorSerial::begin() {
-    MAIN_DOOR_SERIAL.setFIFOSize(1024);
-    MAIN_DOOR_SERIAL.setRX(MAIN_DOOR_RX_PIN);
-    MAIN_DOOR_SERIAL.setTX(MAIN_DOOR_TX_PIN);
-    MAIN_DOOR_SERIAL.begin(MAIN_DOOR_SERIAL_BAUD, MAIN_DOOR_SERIAL_CONFIG);
+void DoorSerial::begin(const DoorSerialConfig& serialConfig) {
+    config = serialConfig;
+    if (config.uart != DOOR_SERIAL_PIO) {
+        config.uart->setFIFOSize(FIFO_SIZE);
+        config.uart->setRX(config.rxPin);
+        config.uart->setTX(config.txPin);
+        serial = config.uart;
+    } else {
+        pioSerial.emplace(config.txPin, config.rxPin, FIFO_SIZE);
+        serial = &*pioSerial;
+    }
+    serial->begin(config.baud, config.config);
     delay(10);
 
     resetState();
     clearReceiveBuffer();
 
-    logDebugP("UART initialized (RX Pin: %d, TX Pin: %d, Baud: %lu)", MAIN_DOOR_RX_PIN, MAIN_DOOR_TX_PIN, MAIN_DOOR_SERIAL_BAUD);
+    logDebugP("%s initialized (RX Pin: %d, TX Pin: %d, Baud: %lu)", pioSerial ? "PIO UART" : "UART", config.rxPin, config.txPin, config.baud);
 }
 
 void DoorSerial::end() {
-    MAIN_DOOR_SERIAL.end();
-    messageQueue.clear();
+    if (serial != nullptr) {
+        serial->end();
+    }
+    queueHead = 0;
+    queueCount = 0;
     resetState();
 }
 
 void DoorSerial::poll() {
+    if (serial == nullptr) {
+        return;
+    }
+
+    if (pioSerial ? pioSerial->overflow() : config.uart->overflow()) {
+        linkStats.uartOverruns++;
+    }
+
     // std::vector<uint8_t> received;
-    while (MAIN_DOOR_SERIAL.available()) {
-        const uint8_t byte = MAIN_DOOR_SERIAL.read();
+    while (serial->available()) {
+        const uint8_t byte = serial->read();
         // received.push_back(byte);
         handleIncomingByte(byte);
     }
@@ -62,7 +79,7 @@ void DoorSerial::poll() {
 }
 
 bool DoorSerial::hasMessage() const {
-    return !messageQueue.empty();
+    return queueCount > 0;
 }
 
 size_t DoorSerial::readMessage(uint8_t* buffer, size_t maxLength) {
@@ -72,170 +89,145 @@ size_t DoorSerial::readMessage(uint8_t* buffer, size_t maxLength) {
 
     poll();
 
-    if (messageQueue.empty()) {
+    if (queueCount == 0) {
         return 0;
     }
 
-    const std::vector<uint8_t>& next = messageQueue.front();
-    if (next.size() > maxLength) {
-        logDebugP("DoorSerial: Message too large for buffer (%zu > %zu)", next.size(), maxLength);
+    const size_t length = messageLength[queueHead];
+    if (length > maxLength) {
+        doorSerialLogDebugP("DoorSerial: Message too large for buffer (%zu > %zu)", length, maxLength);
         return 0;
     }
 
-    std::copy(next.begin(), next.end(), buffer);
-    const size_t length = next.size();
-    messageQueue.pop_front();
+    memcpy(buffer, messageQueue[queueHead], length);
+    queueHead = (queueHead + 1) % MAX_QUEUE_DEPTH;
+    queueCount--;
 
     return length;
 }
 
 bool DoorSerial::sendPayload(const uint8_t* payload, size_t length) {
-    if (payload == nullptr) {
-        logDebugP("DoorSerial: Cannot send payload (serial not initialized or payload null)");
+    if (serial == nullptr || payload == nullptr || length > MAX_MESSAGE_LENGTH) {
+        doorSerialLogDebugP("DoorSerial: Cannot send payload (serial not initialized, payload null or too long)");
         return false;
     }
 
-    std::vector<uint8_t> frame;
-    frame.reserve(length * 2 + 5);
-
-    frame.push_back(DLE);
-    frame.push_back(STX);
-
-    uint8_t checksum = 0x00;
-    for (size_t i = 0; i < length; ++i) {
-        const uint8_t byte = payload[i];
-        if (byte == DLE) {
-            frame.push_back(DLE);
-            frame.push_back(DLE);
-            checksum ^= DLE;
-            checksum ^= DLE;
-        } else {
-            frame.push_back(byte);
-            checksum ^= byte;
-        }
-    }
-
-    frame.push_back(DLE);
-    frame.push_back(ETX);
-    frame.push_back(checksum);
+    uint8_t frame[DoorActiveDriver::frameSize(MAX_MESSAGE_LENGTH)];
+    const size_t frameLength = driver.encode(payload, length, frame);
 
-    const size_t written = MAIN_DOOR_SERIAL.write(frame.data(), frame.size());
-    MAIN_DOOR_SERIAL.flush();
+    const size_t written = serial->write(frame, frameLength);
+    serial->flush();
 
-    // logDebugP("DoorSerial: Sent framed payload (%zu bytes payload, %zu bytes frame)\n", length, frame.size());
+    // logDebugP("DoorSerial: Sent framed payload (%zu bytes payload, %zu bytes frame)\n", length, frameLength);
 
-    return written == frame.size();
+    return written == frameLength;
 }
 
 bool DoorSerial::sendPayload(const std::vector<uint8_t>& payload) {
     return sendPayload(payload.data(), payload.size());
 }
 
-void DoorSerial::setMessageCallback(std::function<void(const std::vector<uint8_t>&)> callback) {
+void DoorSerial::setMessageCallback(std::function<void(const uint8_t*, size_t)> callback) {
     messageCallback = std::move(callback);
 }
 
 void DoorSerial::flush() {
-    MAIN_DOOR_SERIAL.flush();
+    if (serial != nullptr) {
+        serial->flush();
+    }
 }
 
 void DoorSerial::clearReceiveBuffer() {
-    while (MAIN_DOOR_SERIAL.available()) {
-        MAIN_DOOR_SERIAL.read();
+    while (serial != nullptr && serial->available()) {
+        serial->read();
     }
 
     resetState();
 }
 
 void DoorSerial::printStatus() {
-    logDebugP("DoorSerial Status:");
+    logInfoP("DoorSerial Status:");
     logIndentUp();
-    logDebugP("RX Pin: %d", MAIN_DOOR_RX_PIN);
-    logDebugP("TX Pin: %d", MAIN_DOOR_TX_PIN);
-    logDebugP("Baud Rate: %lu", MAIN_DOOR_SERIAL_BAUD);
-    logDebugP("Queued Messages: %zu", messageQueue.size());
-
-    logDebugP("Data Available: %d", MAIN_DOOR_SERIAL.available());
-    logDebugP("Write Buffer Available: %zu", MAIN_DOOR_SERIAL.availableForWrite());
+    logInfoP("Backend: %s", pioSerial ? "PIO UART" : "UART");
+    logInfoP("RX Pin: %d", config.rxPin);
+    logInfoP("TX Pin: %d", config.txPin);
+    logInfoP("Baud Rate: %lu", config.baud);
+    logInfoP("Queued Messages: %u", queueCount);
+
+    if (serial != nullptr) {
+        logInfoP("Data Available: %d", serial->available());
+        logInfoP("Write Buffer Available: %zu", serial->availableForWrite());
+    }
+    logInfoP("Frames OK: %lu", linkStats.framesOk);
+    logInfoP("Checksum Errors: %lu", linkStats.checksumErrors);
+    logInfoP("Framing Errors: %lu", linkStats.framingErrors);
+    logInfoP("Oversize Frames: %lu", linkStats.oversize);
+    logInfoP("Queue Drops: %lu", linkStats.queueDrops);
+    logInfoP("UART Overruns: %lu", linkStats.uartOverruns);
+    logInfoP("Send Timeouts: %lu", linkStats.sendTimeouts);
     logIndentDown();
 }
 
+uint32_t DoorSerial::getLinkErrorCount() const {
+    return linkStats.checksumErrors +
+           linkStats.framingErrors +
+           linkStats.oversize +
+           linkStats.queueDrops +
+           linkStats.uartOverruns +
+           linkStats.sendTimeouts;
+}
+
+void DoorSerial::resetLinkStats() {
+    linkStats = {};
+}
+
 void DoorSerial::resetState() {
-    rxState = RxState::Idle;
-    computedChecksum = 0x00;
-    rxBuffer.clear();
+    driver.resetReceive();
 }
 
 void DoorSerial::handleIncomingByte(uint8_t byte) {
-    switch (rxState) {
-        case RxState::Idle:
-            if (byte == DLE) {
-                rxState = RxState::AwaitStx;
-            }
+    switch (driver.receive(byte)) {
+        case DoorDriverRx::NONE:
             break;
 
-        case RxState::AwaitStx:
-            if (byte == STX) {
-                rxBuffer.clear();
-                computedChecksum = 0x00;
-                rxState = RxState::InFrame;
-            } else if (byte != DLE) {
-                rxState = RxState::Idle;
-            }
+        case DoorDriverRx::FRAME:
+            linkStats.framesOk++;
+            enqueueMessage(driver.payload(), driver.payloadLength());
             break;
 
-        case RxState::InFrame:
-            if (byte == DLE) {
-                rxState = RxState::AfterDle;
-            } else {
-                if (rxBuffer.size() >= MAX_MESSAGE_LENGTH) {
-                    logDebugP("DoorSerial: Discarding message (payload too long)");
-                    resetState();
-                    break;
-                }
-                rxBuffer.push_back(byte);
-                computedChecksum ^= byte;
-            }
+        case DoorDriverRx::CHECKSUM_ERROR:
+            doorSerialLogDebugP("DoorSerial: Checksum mismatch");
+            linkStats.checksumErrors++;
             break;
 
-        case RxState::AfterDle:
-            if (byte == DLE) {
-                if (rxBuffer.size() >= MAX_MESSAGE_LENGTH) {
-                    logDebugP("DoorSerial: Discarding message (payload too long)");
-                    resetState();
-                    break;
-                }
-                computedChecksum ^= DLE;
-                computedChecksum ^= DLE;
-                rxBuffer.push_back(DLE);
-                rxState = RxState::InFrame;
-            } else if (byte == ETX) {
-                rxState = RxState::AwaitChecksum;
-            } else {
-                logDebugP("DoorSerial: Unexpected escape sequence 0x%02X", byte);
-                resetState();
-            }
+        case DoorDriverRx::FRAMING_ERROR:
+            doorSerialLogDebugP("DoorSerial: Unexpected escape sequence 0x%02X", byte);
+            linkStats.framingErrors++;
             break;
 
-        case RxState::AwaitChecksum:
-            if (byte == computedChecksum) {
-                enqueueMessage(rxBuffer);
-            } else {
-                logDebugP("DoorSerial: Checksum mismatch (expected 0x%02X, received 0x%02X)", computedChecksum, byte);
-            }
-            resetState();
+        case DoorDriverRx::OVERSIZE:
+            doorSerialLogDebugP("DoorSerial: Discarding message (payload too long)");
+            linkStats.oversize++;
             break;
     }
 }
 
-void DoorSerial::enqueueMessage(const std::vector<uint8_t>& message) {
-    if (messageQueue.size() >= MAX_QUEUE_DEPTH) {
-        messageQueue.pop_front();
+void DoorSerial::enqueueMessage(const uint8_t* message, size_t length) {
+    // callback consumers never read the queue, so hand the frame over directly
+    // instead of filling (and constantly overrunning) the queue
+    if (messageCallback) {
+        messageCallback(message, length);
+        return;
     }
 
-    messageQueue.push_back(message);
-
-    if (messageCallback) {
-        messageCallback(messageQueue.back());
+    if (queueCount >= MAX_QUEUE_DEPTH) {
+        queueHead = (queueHead + 1) % MAX_QUEUE_DEPTH;
+        queueCount--;
+        linkStats.queueDrops++;
     }
+
+    const uint8_t tail = (queueHead + queueCount) % MAX_QUEUE_DEPTH;
+    memcpy(messageQueue[tail], message, length);
+    messageLength[tail] = length;
+    queueCount++;
 }
\ No newline at end of file
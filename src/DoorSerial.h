@@ -1,43 +1,72 @@
+#pragma once
 #include <Arduino.h>
 #include <SoftwareSerial.h>
 #include "hardware.h"
 #include "OpenKNX.h"
+#include "DoorLog.h"
+#include "DoorDrivers.h"
 
-#include <deque>
 #include <functional>
+#include <optional>
 #include <vector>
 
+// use as DoorSerialConfig::uart to run the link on a PIO UART
+#define DOOR_SERIAL_PIO nullptr
+
+// UART and pins of one drive link, see DOOR_CHANNEL_SERIALS in hardware.h.
+// The RP2040 has two hardware UARTs and KNX uses one of them, so further
+// links run on PIO state machines (SerialPIO, two per link): the PIO does
+// bit timing and parity, the CPU only handles the RX FIFO interrupt.
+struct DoorSerialConfig {
+    SerialUART* uart; // DOOR_SERIAL_PIO: PIO UART on rxPin/txPin
+    pin_size_t rxPin;
+    pin_size_t txPin;
+    uint32_t baud;
+    uint16_t config;
+};
+
 // DoorSerial encapsulates UART communication with the door controller.
-// The protocol uses DLE/STX and DLE/ETX framing with XOR checksum of the
-// transmitted (stuffed) payload bytes. Incoming frames are decoded into
-// payload-only messages that can be consumed via callback or polling.
+// Framing is done by the drive driver (DoorActiveDriver, see DoorDrivers.h).
+// Incoming frames are decoded into payload-only messages that can be
+// consumed via callback or polling.
+// All buffers are fixed size members, so one instance per drive link needs
+// no heap allocation.
 
 class DoorSerial {
-private:
-    enum class RxState : uint8_t {
-        Idle,
-        AwaitStx,
-        InFrame,
-        AfterDle,
-        AwaitChecksum
+public:
+    // link health counters, always enabled
+    struct LinkStats {
+        uint32_t framesOk;
+        uint32_t checksumErrors;
+        uint32_t framingErrors;
+        uint32_t oversize;
+        uint32_t queueDrops;
+        uint32_t uartOverruns;
+        uint32_t sendTimeouts;
     };
 
-    RxState rxState;
-    uint8_t computedChecksum;
-    std::vector<uint8_t> rxBuffer;
-    std::deque<std::vector<uint8_t>> messageQueue;
+private:
+    static constexpr size_t MAX_QUEUE_DEPTH = 4;
+    static constexpr size_t MAX_MESSAGE_LENGTH = DoorActiveDriver::RX_SIZE;
+    static constexpr size_t FIFO_SIZE = 1024;
 
-    std::function<void(const std::vector<uint8_t>&)> messageCallback;
+    DoorSerialConfig config = {};
+    std::optional<SerialPIO> pioSerial;
+    HardwareSerial* serial = nullptr; // config.uart or pioSerial
+    DoorActiveDriver driver;
+    LinkStats linkStats = {};
+
+    // ring of received messages for polling consumers
+    uint8_t messageQueue[MAX_QUEUE_DEPTH][MAX_MESSAGE_LENGTH];
+    size_t messageLength[MAX_QUEUE_DEPTH] = {};
+    uint8_t queueHead = 0;
+    uint8_t queueCount = 0;
+
+    std::function<void(const uint8_t*, size_t)> messageCallback;
 
     void resetState();
     void handleIncomingByte(uint8_t byte);
-    void enqueueMessage(const std::vector<uint8_t>& message);
-
-    static constexpr uint8_t DLE = 0x10;
-    static constexpr uint8_t STX = 0x02;
-    static constexpr uint8_t ETX = 0x03;
-    static constexpr size_t MAX_QUEUE_DEPTH = 4;
-    static constexpr size_t MAX_MESSAGE_LENGTH = 128;
+    void enqueueMessage(const uint8_t* message, size_t length);
     
 public:
     static constexpr size_t MaxMessageLength = MAX_MESSAGE_LENGTH;
@@ -51,7 +80,7 @@ public:
     std::string logPrefix();
 
     // Initialization
-    void begin();
+    void begin(const DoorSerialConfig& serialConfig);
     void end();
 
     // Processing
@@ -62,7 +91,7 @@ public:
     // Communication methods
     bool sendPayload(const uint8_t* payload, size_t length);
     bool sendPayload(const std::vector<uint8_t>& payload);
-    void setMessageCallback(std::function<void(const std::vector<uint8_t>&)> callback);
+    void setMessageCallback(std::function<void(const uint8_t*, size_t)> callback);
     
     // Legacy helpers (for compatibility)
     inline bool hasData() const { return hasMessage(); }
@@ -79,4 +108,10 @@ public:
     inline void updatePeriodicSend() {}
     
     void printStatus();
+
+    // Link health
+    inline const LinkStats& getLinkStats() const { return linkStats; }
+    inline void countSendTimeout() { linkStats.sendTimeouts++; }
+    uint32_t getLinkErrorCount() const;
+    void resetLinkStats();
 };
\ No newline at end of file
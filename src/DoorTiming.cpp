@@ -0,0 +1,94 @@
+#include "DoorTiming.h"
+#include <cstring>
+
+void DoorTiming::addSample(Metric metric, uint32_t ms)
+{
+    Estimate &estimate = _estimates[metric];
+
+    // scaled values are 16 bit, limit samples to keep them in range
+    if (ms > 8000)
+        ms = 8000;
+
+    if (estimate.samples == 0)
+    {
+        estimate.mean8 = ms << 3;
+        estimate.deviation4 = ms << 1; // deviation = mean / 2
+    }
+    else
+    {
+        int32_t error = (int32_t)ms - (estimate.mean8 >> 3);
+        estimate.mean8 += error; // mean += error / 8
+        if (error < 0)
+            error = -error;
+        estimate.deviation4 += error - (estimate.deviation4 >> 2); // deviation += (|error| - deviation) / 4
+    }
+
+    if (estimate.samples < UINT16_MAX)
+        estimate.samples++;
+
+    if (estimate.baseline == 0 && estimate.samples >= DOOR_TIMING_BASELINE_SAMPLES)
+    {
+        estimate.baseline = estimate.mean8 >> 3;
+        logDebugP("%s baseline learned: %u ms", metricName(metric), estimate.baseline);
+    }
+}
+
+uint32_t DoorTiming::timeout(Metric metric, uint32_t minimum, uint32_t fallback) const
+{
+    if (!learned(metric))
+        return fallback;
+
+    const uint32_t learnedTimeout = mean(metric) + DOOR_TIMING_DEVIATION_FACTOR * deviation(metric);
+    if (learnedTimeout < minimum)
+        return minimum;
+    if (learnedTimeout > fallback)
+        return fallback;
+    return learnedTimeout;
+}
+
+bool DoorTiming::degraded() const
+{
+    for (uint8_t i = 0; i < METRIC_COUNT; i++)
+    {
+        const Estimate &estimate = _estimates[i];
+        if (estimate.baseline == 0)
+            continue;
+
+        const uint32_t current = estimate.mean8 >> 3;
+        if (current * 100 > (uint32_t)estimate.baseline * DOOR_TIMING_DEGRADED_PERCENT &&
+            current > (uint32_t)estimate.baseline + DOOR_TIMING_DEGRADED_MARGIN)
+            return true;
+    }
+    return false;
+}
+
+void DoorTiming::reset()
+{
+    memset(_estimates, 0, sizeof(_estimates));
+}
+
+void DoorTiming::printStatus()
+{
+    logInfoP("Learned drive timing:");
+    logIndentUp();
+    for (uint8_t i = 0; i < METRIC_COUNT; i++)
+    {
+        const Metric metric = static_cast<Metric>(i);
+        const Estimate &estimate = _estimates[i];
+        logInfoP("%-9s mean=%lu ms dev=%lu ms baseline=%u ms n=%u", metricName(metric), mean(metric), deviation(metric), estimate.baseline, estimate.samples);
+    }
+    logInfoP("Degraded: %i", degraded());
+    logIndentDown();
+}
+
+const char *DoorTiming::metricName(Metric metric)
+{
+    switch (metric)
+    {
+        case METRIC_OPENING: return "opening";
+        case METRIC_CLOSING: return "closing";
+        case METRIC_RESPONSE: return "response";
+        case METRIC_COMMAND: return "command";
+        default: return "unknown";
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <Arduino.h>
+#include <cstddef>
+#include <cstdint>
+#include "OpenKNX.h"
+
+#define DOOR_TIMING_DEVIATION_FACTOR 4
+#define DOOR_TIMING_MIN_SAMPLES 8
+#define DOOR_TIMING_BASELINE_SAMPLES 32
+#define DOOR_TIMING_DEGRADED_PERCENT 150
+#define DOOR_TIMING_DEGRADED_MARGIN 50 // ms, short metrics (response) must not trip on serial jitter
+
+// DoorTiming learns the timing of the connected drive online: opening and
+// closing duration, the turnaround of the serial protocol and the time from
+// a command to the first state change. Each metric uses the integer mean /
+// mean deviation estimator known from TCP RTT estimation (Jacobson), so no
+// floating point is needed. Timeouts are derived as mean + 4 * deviation and
+// limited to the fixed defaults, a degrading drive must not stretch them.
+// After DOOR_TIMING_BASELINE_SAMPLES the mean is frozen as baseline, a mean
+// above DOOR_TIMING_DEGRADED_PERCENT of the baseline and at least
+// DOOR_TIMING_DEGRADED_MARGIN above it marks the drive degraded.
+
+class DoorTiming
+{
+  public:
+    enum Metric : uint8_t
+    {
+        METRIC_OPENING,
+        METRIC_CLOSING,
+        METRIC_RESPONSE,
+        METRIC_COMMAND,
+        METRIC_COUNT
+    };
+
+    struct Estimate
+    {
+        uint16_t mean8;      // mean in ms, scaled by 8
+        uint16_t deviation4; // mean deviation in ms, scaled by 4
+        uint16_t baseline;   // ms, 0 until enough samples
+        uint16_t samples;
+    };
+
+    void addSample(Metric metric, uint32_t ms);
+    // learned timeout within minimum..fallback, fallback until enough samples are known
+    uint32_t timeout(Metric metric, uint32_t minimum, uint32_t fallback) const;
+    bool degraded() const;
+    void reset();
+    void printStatus();
+
+    inline uint32_t mean(Metric metric) const { return _estimates[metric].mean8 >> 3; }
+    inline uint32_t deviation(Metric metric) const { return _estimates[metric].deviation4 >> 2; }
+    inline bool learned(Metric metric) const { return _estimates[metric].samples >= DOOR_TIMING_MIN_SAMPLES; }
+
+    // persistence (DoorPersistence TLV)
+    inline const Estimate *estimates() const { return _estimates; }
+    inline Estimate *estimates() { return _estimates; }
+
+    static const char *metricName(Metric metric);
+    std::string logPrefix() { return "DoorTiming"; }
+
+  private:
+    Estimate _estimates[METRIC_COUNT] = {};
+};
@@ -0,0 +1,97 @@
+#include "DoorTraffic.h"
+
+void DoorTraffic::trigger(uint32_t now)
+{
+    // interval += (sample - interval) / 8, kept times 8 so it settles on the sample
+    const uint32_t sample = std::min(now - _lastTrigger, (uint32_t)DOOR_TRAFFIC_INTERVAL_MAX);
+    _interval8 += sample - _interval8 / 8;
+    _lastTrigger = now;
+
+    if (!_open)
+    {
+        // the fixed policy would still have been open: a cycle the short hold cost.
+        // closed() counted the fixed door open until its hold ended, it stays
+        // open and only the time the door stood closed is missing from it.
+        const int32_t late = fixedLate(now);
+        if (_closedEarly && late < 0)
+        {
+            const int32_t closed = (int32_t)(now - _closedAt);
+            _lostCycles++;
+            _extendedOpen += closed - late - std::max(closed - (int32_t)_closingTime, (int32_t)0);
+            _lost = true;
+            logDebugP("Cycle lost by short hold");
+        }
+        _closedEarly = false;
+        return;
+    }
+
+    // the fixed policy would have closed: a cycle, open again one opening time
+    // after it reached the closed position or the trigger. Out of the closed
+    // position it only misses the time it stood closed.
+    const int32_t late = fixedLate(now);
+    if (late > 0)
+    {
+        _savedCycles++;
+        _extendedOpen += std::max(late - (int32_t)_closingTime, (int32_t)0);
+        _openSince = now + std::max((int32_t)_closingTime - late, (int32_t)0) + _openingTime;
+        logDebugP("Cycle saved by extended hold");
+    }
+}
+
+uint32_t DoorTraffic::holdTime(uint32_t base, uint32_t max) const
+{
+    const uint32_t hold = _interval8 / 8 * 3 / 2;
+    if (hold > max)
+        return std::min(base, (uint32_t)DOOR_OPEN_HOLD_MIN);
+
+    return std::max(base, hold);
+}
+
+void DoorTraffic::opened(uint32_t now, uint32_t base, uint32_t openingTime, uint32_t closingTime)
+{
+    // after a lost cycle the fixed door was open all the time, its hold goes on
+    _open = true;
+    _closedEarly = false;
+    _openSince = _lost ? _openSince : now;
+    _lost = false;
+    _openBase = base;
+    _openingTime = openingTime;
+    _closingTime = closingTime;
+}
+
+void DoorTraffic::closed(uint32_t now)
+{
+    if (!_open)
+        return;
+
+    // negative when the door closed before the fixed policy would have
+    _open = false;
+    const int32_t late = fixedLate(now);
+    _closedEarly = late < 0;
+    _closedAt = now;
+    _extendedOpen += late;
+}
+
+void DoorTraffic::held(bool active, uint32_t now)
+{
+    if (_held && !active)
+        _releasedAt = now;
+    _held = active;
+}
+
+int32_t DoorTraffic::fixedLate(uint32_t now) const
+{
+    // the fixed policy closes after its hold and once no sensor holds the door
+    if (_held)
+        return std::min((int32_t)(now - _openSince - _openBase), (int32_t)0);
+    return std::min((int32_t)(now - _openSince - _openBase), (int32_t)(now - _releasedAt));
+}
+
+void DoorTraffic::printStatus()
+{
+    logInfoP("Adaptive hold-open:");
+    logIndentUp();
+    logInfoP("Mean trigger interval: %lu ms, last trigger %lu ms ago", _interval8 / 8, millis() - _lastTrigger);
+    logInfoP("Saved cycles: %lu, lost cycles: %lu, extended open time: %ld s", _savedCycles, _lostCycles, _extendedOpen / 1000);
+    logIndentDown();
+}
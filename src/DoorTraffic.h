@@ -0,0 +1,67 @@
+#pragma once
+#include <Arduino.h>
+#include <cstddef>
+#include <cstdint>
+#include "OpenKNX.h"
+#include "hardware.h"
+
+#define DOOR_TRAFFIC_INTERVAL_MAX 60000
+
+// DoorTraffic adapts the hold-open time in automatic mode to the recent
+// trigger rate. It keeps a moving average of the time between radar
+// triggers: while the next person is expected before the door would have
+// closed (dense traffic), the door is held open for 1.5 mean intervals after
+// the last trigger instead of cycling, at least the fixed hold time and up
+// to the configured maximum. The mean only changes with a trigger, silence
+// never extends a running hold; it enters the mean as a long interval with
+// the next trigger. With sparse traffic the door closes after
+// DOOR_OPEN_HOLD_MIN.
+//
+// The counters compare with the fixed policy, which holds DOOR_OPEN_MIN after
+// OPEN and while a radar or AIR sensor is active. A trigger after it would
+// have closed is a saved cycle, a trigger after a shorter hold that it would
+// still have served is a lost one. The extended open time is the net time
+// the door was out of the closed position beyond the fixed policy (heat
+// loss), the drive time of a saved cycle taken into account. See
+// test/test_traffic for the simulated trade-off.
+
+class DoorTraffic
+{
+  public:
+    void trigger(uint32_t now);
+    // hold time in ms after lastTrigger(), base is the hold time of the fixed policy
+    uint32_t holdTime(uint32_t base, uint32_t max) const;
+    inline uint32_t lastTrigger() const { return _lastTrigger; }
+
+    // base is the fixed hold after OPEN, the drive times those of a cycle
+    void opened(uint32_t now, uint32_t base, uint32_t openingTime, uint32_t closingTime);
+    void closed(uint32_t now);
+    // radar or AIR sensors that keep the door open, see DoorChannel::guardAutomaticClose()
+    void held(bool active, uint32_t now);
+    inline uint32_t savedCycles() const { return _savedCycles; }
+    inline uint32_t lostCycles() const { return _lostCycles; }
+    inline int32_t extendedOpen() const { return _extendedOpen; }
+
+    void printStatus();
+    std::string logPrefix() { return "DoorTraffic"; }
+
+  private:
+    // ms since the fixed policy would have closed the door, <= 0 while it would hold it
+    int32_t fixedLate(uint32_t now) const;
+
+    uint32_t _interval8 = DOOR_TRAFFIC_INTERVAL_MAX * 8; // ms * 8
+    uint32_t _lastTrigger = 0;
+    bool _open = false;
+    bool _closedEarly = false;
+    bool _lost = false;
+    bool _held = false;
+    uint32_t _releasedAt = 0;
+    uint32_t _closedAt = 0;
+    uint32_t _openSince = 0;
+    uint32_t _openBase = 0;
+    uint32_t _openingTime = 0;
+    uint32_t _closingTime = 0;
+    uint32_t _savedCycles = 0;
+    uint32_t _lostCycles = 0;
+    int32_t _extendedOpen = 0; // ms beyond the fixed policy, negative when shorter
+};
@@ -5,6 +5,16 @@
 #include "VirtualButtonModule.h"
 #include <Arduino.h>
 
+// door status changes reach the logic channels within the door loop instead
+// of via the KO queue, logic inputs are bound to the door status KOs; the KO
+// is set to the value of the record, the logic sees every intermediate state
+void forwardDoorEvent(const DoorEvents::Record &record, void *context)
+{
+    GroupObject *ko = openknxDoorControllerModule.eventKo(record);
+    if (ko != nullptr)
+        openknxLogic.processInputKo(*ko);
+}
+
 void setup()
 {
     const uint8_t firmwareRevision = 0;
@@ -13,6 +23,8 @@ void setup()
     openknx.addModule(2, openknxDoorControllerModule);
     openknx.addModule(3, openknxVirtualButtonModule);
     openknx.addModule(9, openknxFileTransferModule);
+    // before setup, readFlash() publishes the restored door mode; dispatched with the first loop
+    openknxDoorControllerModule.doorEvents.subscribe(DoorEvents::EVENTS_ALL, &forwardDoorEvent);
     openknx.setup();
 
     // call direct for testing without KNX connected
@@ -0,0 +1,275 @@
+#pragma once
+#include <unity.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "DoorDriver.h"
+
+// Conformance suite and benchmark for a DoorDriver<Driver>, see DoorDriver.h.
+// Every driver gets a test/test_driver_<name> suite that runs these checks
+// and adds its protocol specific cases:
+//
+//   builtinCommands  built-in payloads survive encode/receive, conforms()
+//   payloads         every byte value at every position and random payloads
+//   backToBack       consecutive frames without a gap
+//   resync           a frame after line noise or a truncated frame
+//   corruption       a single bit error is never received as a valid frame
+//   oversize         a payload beyond RX_SIZE is rejected, the next frame received
+//   states           the state commands decode as the state they request
+//   benchmark        encode and receive cost per frame
+
+#define DOOR_CONFORMANCE_RANDOM 10000
+#define DOOR_CONFORMANCE_BENCH_ROUNDS 100000
+
+template <typename Driver>
+class DoorDriverConformance
+{
+  public:
+    typedef std::vector<uint8_t> Bytes;
+
+    struct BenchResult
+    {
+        double encodeNs;  // per frame
+        double receiveNs; // per frame
+        size_t frameBytes;
+        uint32_t received; // frames, one per round
+    };
+
+    static Bytes encode(const uint8_t *payload, size_t length)
+    {
+        Bytes frame(Driver::frameSize(length));
+        Driver driver;
+        frame.resize(driver.encode(payload, length, frame.data()));
+        return frame;
+    }
+
+    // results of all bytes that did not return NONE, payload of the last FRAME
+    static std::vector<DoorDriverRx> receive(Driver &driver, const Bytes &bytes, Bytes *payload = nullptr)
+    {
+        std::vector<DoorDriverRx> results;
+        for (const uint8_t byte : bytes)
+        {
+            const DoorDriverRx result = driver.receive(byte);
+            if (result == DoorDriverRx::NONE)
+                continue;
+
+            results.push_back(result);
+            if (result == DoorDriverRx::FRAME && payload != nullptr)
+                payload->assign(driver.payload(), driver.payload() + driver.payloadLength());
+        }
+        return results;
+    }
+
+    static bool roundTrip(const uint8_t *payload, size_t length)
+    {
+        const Bytes frame = encode(payload, length);
+        if (frame.size() > Driver::frameSize(length))
+            return false;
+
+        Driver driver;
+        Bytes received;
+        const std::vector<DoorDriverRx> results = receive(driver, frame, &received);
+        return results.size() == 1 && results[0] == DoorDriverRx::FRAME && received == Bytes(payload, payload + length);
+    }
+
+    static void builtinCommands()
+    {
+        TEST_ASSERT_TRUE(Driver::conforms());
+        for (uint8_t id = 0; id < DOOR_COMMAND_COUNT; id++)
+        {
+            const DoorCommandDefinition &definition = Driver::command(static_cast<DoorCommandId>(id));
+            for (size_t i = 0; i < definition.prefixCount; i++)
+                TEST_ASSERT_TRUE(roundTrip(definition.prefixPayloads[i], Driver::PAYLOAD_SIZE));
+            TEST_ASSERT_TRUE(roundTrip(definition.finalPayload, Driver::PAYLOAD_SIZE));
+        }
+    }
+
+    static void payloads()
+    {
+        uint8_t payload[Driver::PAYLOAD_SIZE];
+        for (uint16_t value = 0; value < 256; value++)
+        {
+            for (size_t position = 0; position < Driver::PAYLOAD_SIZE; position++)
+            {
+                memset(payload, 0, sizeof(payload));
+                payload[position] = value;
+                TEST_ASSERT_TRUE(roundTrip(payload, sizeof(payload)));
+            }
+
+            // all bytes equal, e.g. all of them to be escaped
+            memset(payload, value, sizeof(payload));
+            TEST_ASSERT_TRUE(roundTrip(payload, sizeof(payload)));
+        }
+
+        uint32_t seed = 0x5EED;
+        for (uint32_t i = 0; i < DOOR_CONFORMANCE_RANDOM; i++)
+        {
+            for (uint8_t &byte : payload)
+                byte = random(seed);
+            TEST_ASSERT_TRUE(roundTrip(payload, sizeof(payload)));
+        }
+    }
+
+    static void backToBack()
+    {
+        Bytes stream;
+        for (uint8_t id = 0; id < DOOR_COMMAND_COUNT; id++)
+        {
+            const Bytes frame = encode(Driver::command(static_cast<DoorCommandId>(id)).finalPayload, Driver::PAYLOAD_SIZE);
+            stream.insert(stream.end(), frame.begin(), frame.end());
+        }
+
+        Driver driver;
+        const std::vector<DoorDriverRx> results = receive(driver, stream);
+        TEST_ASSERT_EQUAL(DOOR_COMMAND_COUNT, results.size());
+        for (const DoorDriverRx result : results)
+            TEST_ASSERT_TRUE(result == DoorDriverRx::FRAME);
+    }
+
+    static void resync()
+    {
+        const uint8_t *payload = Driver::command(DOOR_COMMAND_OPEN).finalPayload;
+        const Bytes frame = encode(payload, Driver::PAYLOAD_SIZE);
+        uint32_t seed = 0xACE;
+
+        for (uint32_t i = 0; i < 1000; i++)
+        {
+            // noise or the start of a frame, then two valid frames; at the
+            // latest the second one must be received
+            Bytes stream;
+            const size_t noise = random(seed) % 32;
+            if (i % 2 == 0)
+            {
+                for (size_t j = 0; j < noise; j++)
+                    stream.push_back(random(seed));
+            }
+            else
+            {
+                stream.assign(frame.begin(), frame.begin() + noise % frame.size());
+            }
+            stream.insert(stream.end(), frame.begin(), frame.end());
+            stream.insert(stream.end(), frame.begin(), frame.end());
+
+            Driver driver;
+            Bytes received;
+            const std::vector<DoorDriverRx> results = receive(driver, stream, &received);
+            TEST_ASSERT_FALSE(results.empty());
+            TEST_ASSERT_TRUE(results.back() == DoorDriverRx::FRAME);
+            TEST_ASSERT_TRUE(received == Bytes(payload, payload + Driver::PAYLOAD_SIZE));
+        }
+    }
+
+    static void corruption()
+    {
+        for (uint8_t id = 0; id < DOOR_COMMAND_COUNT; id++)
+        {
+            const uint8_t *payload = Driver::command(static_cast<DoorCommandId>(id)).finalPayload;
+            const Bytes frame = encode(payload, Driver::PAYLOAD_SIZE);
+            for (size_t position = 0; position < frame.size(); position++)
+            {
+                for (uint8_t bit = 0; bit < 8; bit++)
+                {
+                    Bytes stream = frame;
+                    stream[position] ^= 1 << bit;
+
+                    Driver driver;
+                    Bytes received;
+                    for (const DoorDriverRx result : receive(driver, stream, &received))
+                        TEST_ASSERT_FALSE(result == DoorDriverRx::FRAME && received != Bytes(payload, payload + Driver::PAYLOAD_SIZE));
+
+                    // and the receiver is not stuck, at the latest the second repetition comes through
+                    receive(driver, frame);
+                    const std::vector<DoorDriverRx> repeated = receive(driver, frame);
+                    TEST_ASSERT_TRUE(repeated.size() == 1 && repeated[0] == DoorDriverRx::FRAME);
+                }
+            }
+        }
+    }
+
+    static void oversize()
+    {
+        std::vector<uint8_t> payload(Driver::RX_SIZE + 1, 0x55);
+        Driver driver;
+        const std::vector<DoorDriverRx> results = receive(driver, encode(payload.data(), payload.size()));
+        TEST_ASSERT_FALSE(results.empty());
+        TEST_ASSERT_TRUE(results.front() == DoorDriverRx::OVERSIZE);
+
+        const uint8_t *open = Driver::command(DOOR_COMMAND_OPEN).finalPayload;
+        Bytes received;
+        const std::vector<DoorDriverRx> next = receive(driver, encode(open, Driver::PAYLOAD_SIZE), &received);
+        TEST_ASSERT_TRUE(next.size() == 1 && next[0] == DoorDriverRx::FRAME);
+        TEST_ASSERT_TRUE(received == Bytes(open, open + Driver::PAYLOAD_SIZE));
+
+        // the largest accepted payload
+        payload.pop_back();
+        TEST_ASSERT_TRUE(roundTrip(payload.data(), payload.size()));
+    }
+
+    static void states()
+    {
+        TEST_ASSERT_TRUE(Driver::state(Driver::command(DOOR_COMMAND_OPEN).finalPayload) == DoorDriverState::OPEN);
+        TEST_ASSERT_TRUE(Driver::state(Driver::command(DOOR_COMMAND_CLOSED).finalPayload) == DoorDriverState::CLOSED);
+        TEST_ASSERT_TRUE(Driver::state(Driver::command(DOOR_COMMAND_OPENING).finalPayload) == DoorDriverState::OPENING);
+        TEST_ASSERT_TRUE(Driver::state(Driver::command(DOOR_COMMAND_CLOSING).finalPayload) == DoorDriverState::CLOSING);
+    }
+
+    // the built-in final payloads, encoded into and received from a fixed buffer like DoorSerial
+    static BenchResult benchmark()
+    {
+        uint8_t frame[Driver::frameSize(Driver::PAYLOAD_SIZE)];
+        size_t frameBytes = 0;
+        Driver driver;
+
+        const auto encodeStart = std::chrono::steady_clock::now();
+        for (uint32_t round = 0; round < DOOR_CONFORMANCE_BENCH_ROUNDS; round++)
+        {
+            const uint8_t *payload = Driver::command(static_cast<DoorCommandId>(round % DOOR_COMMAND_COUNT)).finalPayload;
+            const size_t length = driver.encode(payload, Driver::PAYLOAD_SIZE, frame);
+            _sink += frame[length - 1];
+        }
+        const auto encodeEnd = std::chrono::steady_clock::now();
+
+        Bytes frames[DOOR_COMMAND_COUNT];
+        for (uint8_t id = 0; id < DOOR_COMMAND_COUNT; id++)
+        {
+            frames[id] = encode(Driver::command(static_cast<DoorCommandId>(id)).finalPayload, Driver::PAYLOAD_SIZE);
+            frameBytes += frames[id].size();
+        }
+
+        uint32_t received = 0;
+        const auto receiveStart = std::chrono::steady_clock::now();
+        for (uint32_t round = 0; round < DOOR_CONFORMANCE_BENCH_ROUNDS; round++)
+        {
+            for (const uint8_t byte : frames[round % DOOR_COMMAND_COUNT])
+            {
+                if (driver.receive(byte) == DoorDriverRx::FRAME)
+                {
+                    received++;
+                    _sink += driver.payload()[Driver::PAYLOAD_SIZE - 1];
+                }
+            }
+        }
+        const auto receiveEnd = std::chrono::steady_clock::now();
+
+        return {std::chrono::duration<double, std::nano>(encodeEnd - encodeStart).count() / DOOR_CONFORMANCE_BENCH_ROUNDS,
+                std::chrono::duration<double, std::nano>(receiveEnd - receiveStart).count() / DOOR_CONFORMANCE_BENCH_ROUNDS,
+                frameBytes / DOOR_COMMAND_COUNT, received};
+    }
+
+    static void report(const char *name, const BenchResult &result)
+    {
+        printf("  %s: encode %6.1f ns/frame, receive %6.1f ns/frame (%u bytes, %5.2f ns/byte)\n", name, result.encodeNs,
+               result.receiveNs, (unsigned)result.frameBytes, result.receiveNs / result.frameBytes);
+    }
+
+  private:
+    // keeps the benchmarked work from being optimised away
+    static inline volatile size_t _sink = 0;
+
+    static uint8_t random(uint32_t &seed)
+    {
+        seed = seed * 1103515245 + 12345;
+        return seed >> 16;
+    }
+};
@@ -0,0 +1,17 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+// Arduino API for the native test environment, only what the pure logic
+// classes under test use. millis() is driven by the tests via stubMillis.
+
+#define HIGH 1
+#define LOW 0
+
+typedef uint8_t byte;
+
+inline uint32_t stubMillis = 0;
+inline unsigned long millis() { return stubMillis; }
@@ -0,0 +1,40 @@
+#pragma once
+#include <Arduino.h>
+#include <cstdarg>
+#include <string>
+
+// OpenKNX logging and timing helpers for the native test environment.
+// Log output is dropped unless DOOR_TEST_LOG is defined.
+
+#ifdef DOOR_TEST_LOG
+inline void doorTestLog(const char *level, const std::string &prefix, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    printf("%-5s %s: ", level, prefix.c_str());
+    vprintf(format, args);
+    printf("\n");
+    va_end(args);
+}
+#else
+inline void doorTestLog(const char *level, const std::string &prefix, const char *format, ...) {}
+#endif
+
+#define logErrorP(...) doorTestLog("ERROR", logPrefix(), __VA_ARGS__)
+#define logInfoP(...) doorTestLog("INFO", logPrefix(), __VA_ARGS__)
+#define logDebugP(...) doorTestLog("DEBUG", logPrefix(), __VA_ARGS__)
+#define logTraceP(...) doorTestLog("TRACE", logPrefix(), __VA_ARGS__)
+#define logError(prefix, ...) doorTestLog("ERROR", prefix, __VA_ARGS__)
+#define logInfo(prefix, ...) doorTestLog("INFO", prefix, __VA_ARGS__)
+#define logDebug(prefix, ...) doorTestLog("DEBUG", prefix, __VA_ARGS__)
+#define logIndentUp() \
+    do                \
+    {                 \
+    } while (0)
+#define logIndentDown() \
+    do                  \
+    {                   \
+    } while (0)
+
+inline bool delayCheckMillis(uint32_t since, uint32_t delay) { return millis() - since >= delay; }
+inline uint32_t delayTimerInit() { return millis() == 0 ? 1 : millis(); }
@@ -0,0 +1,291 @@
+#include <unity.h>
+#include <cstdio>
+#include <vector>
+#include "hardware.h"
+#include "DoorAirlock.h"
+
+// Airlock throughput on the host: two doors (0 outer, 1 inner) run a small
+// model of the channel state machine (CLOSED -> TRANSITION -> OPEN -> CLOSING)
+// and open through doorAirlockOpenAllowed(). Each door has one radar and one
+// AIR sensor covering both of its sides. People wait at their first door,
+// cross it, walk through the vestibule, wait at the second door and cross it.
+//
+// pipelined: doorAirlockWaiting() closes the open door after DOOR_OPEN_HOLD_MIN
+// fixed:     the open door always holds DOOR_OPEN_MIN
+//
+// Both doors must never be out of the closed position at the same time.
+
+#define DOOR_SIM_STEP 10
+#define DOOR_SIM_COMMAND 200     // command to drive moving
+#define DOOR_SIM_DRIVE_TIME 2000 // closed to open and back
+#define DOOR_SIM_CROSS_TIME 800
+#define DOOR_SIM_VESTIBULE 1500 // walk from one door to the other
+#define DOOR_SIM_DOORS 2
+#define DOOR_SIM_TIMEOUT 3600000
+
+struct SimDoor
+{
+    enum Machine : uint8_t
+    {
+        CLOSED,
+        TRANSITION,
+        OPEN,
+        CLOSING
+    } machine = CLOSED;
+    uint32_t position = 0; // ms of drive time, 0 closed
+    uint32_t since = 0;    // TRANSITION: command, OPEN: fully open
+    bool radar = false;
+    bool air = false;
+};
+
+struct SimPerson
+{
+    enum Phase : uint8_t
+    {
+        WAIT_FIRST,
+        CROSS_FIRST,
+        VESTIBULE,
+        WAIT_SECOND,
+        CROSS_SECOND,
+        DONE
+    };
+
+    uint32_t arrival;
+    uint8_t first; // 0 entering, 1 leaving
+    Phase phase;
+    uint32_t since;
+};
+
+struct SimResult
+{
+    uint32_t people;
+    uint32_t duration; // first arrival to last person through, ms
+    uint64_t transitSum;
+    uint32_t transitMax;
+    uint32_t violations; // both doors out of the closed position
+    float perMinute() const { return people * 60000.0f / duration; }
+    uint32_t transitMean() const { return people ? transitSum / people : 0; }
+};
+
+static SimResult simulate(std::vector<SimPerson> people, bool pipelined)
+{
+    SimDoor doors[DOOR_SIM_DOORS];
+    SimResult result = {};
+    uint32_t done = 0;
+    const uint32_t start = people.empty() ? 0 : people.front().arrival;
+
+    for (uint32_t now = start; done < people.size() && now < DOOR_SIM_TIMEOUT; now += DOOR_SIM_STEP)
+    {
+        // people and sensors
+        for (SimDoor &door : doors)
+            door.radar = door.air = false;
+
+        for (SimPerson &person : people)
+        {
+            if (now < person.arrival || person.phase == SimPerson::DONE)
+                continue;
+
+            const uint8_t door = person.phase < SimPerson::VESTIBULE ? person.first : 1 - person.first;
+            const bool open = doors[door].machine == SimDoor::OPEN && doors[door].position == DOOR_SIM_DRIVE_TIME;
+            switch (person.phase)
+            {
+                case SimPerson::WAIT_FIRST:
+                case SimPerson::WAIT_SECOND:
+                    if (open)
+                    {
+                        person.phase = static_cast<SimPerson::Phase>(person.phase + 1);
+                        person.since = now;
+                    }
+                    break;
+                case SimPerson::CROSS_FIRST:
+                case SimPerson::VESTIBULE:
+                    if (now - person.since >= (person.phase == SimPerson::VESTIBULE ? DOOR_SIM_VESTIBULE : DOOR_SIM_CROSS_TIME))
+                    {
+                        person.phase = static_cast<SimPerson::Phase>(person.phase + 1);
+                        person.since = now;
+                    }
+                    break;
+                case SimPerson::CROSS_SECOND:
+                    if (now - person.since >= DOOR_SIM_CROSS_TIME)
+                    {
+                        const uint32_t transit = now - person.arrival;
+                        person.phase = SimPerson::DONE;
+                        done++;
+                        result.people++;
+                        result.transitSum += transit;
+                        result.transitMax = transit > result.transitMax ? transit : result.transitMax;
+                        result.duration = now - start;
+                    }
+                    break;
+                case SimPerson::DONE:
+                    break;
+            }
+
+            if (person.phase == SimPerson::VESTIBULE || person.phase == SimPerson::DONE)
+                continue;
+            doors[door].radar = true;
+            doors[door].air = doors[door].air || person.phase == SimPerson::CROSS_FIRST || person.phase == SimPerson::CROSS_SECOND;
+        }
+
+        // state machines, in channel order like the module
+        for (uint8_t i = 0; i < DOOR_SIM_DOORS; i++)
+        {
+            DoorAirlockChannel airlock[DOOR_SIM_DOORS];
+            for (uint8_t j = 0; j < DOOR_SIM_DOORS; j++)
+            {
+                airlock[j] = {doors[j].position == 0, doors[j].machine == SimDoor::TRANSITION,
+                              doors[j].machine == SimDoor::OPEN, doors[j].radar};
+            }
+
+            SimDoor &door = doors[i];
+            switch (door.machine)
+            {
+                case SimDoor::CLOSED:
+                    if (door.radar && doorAirlockOpenAllowed(airlock, i))
+                    {
+                        door.machine = SimDoor::TRANSITION;
+                        door.since = now;
+                    }
+                    break;
+                case SimDoor::TRANSITION:
+                    // the state machine leaves TRANSITION when the drive reports OPENING
+                    if (now - door.since < DOOR_SIM_COMMAND)
+                        break;
+                    door.machine = SimDoor::OPEN;
+                    door.position += DOOR_SIM_STEP;
+                    break;
+                case SimDoor::OPEN:
+                {
+                    if (door.position < DOOR_SIM_DRIVE_TIME)
+                    {
+                        door.position += DOOR_SIM_STEP;
+                        door.since = now;
+                        break;
+                    }
+
+                    const uint32_t hold = pipelined && doorAirlockWaiting(airlock, i) ? DOOR_OPEN_HOLD_MIN : DOOR_OPEN_MIN;
+                    if (!door.radar && !door.air && now - door.since >= hold)
+                        door.machine = SimDoor::CLOSING;
+                    break;
+                }
+                case SimDoor::CLOSING:
+                    door.position -= DOOR_SIM_STEP;
+                    if (door.position == 0)
+                        door.machine = SimDoor::CLOSED;
+                    break;
+            }
+        }
+
+        if (doors[0].position > 0 && doors[1].position > 0)
+            result.violations++;
+    }
+
+    return result;
+}
+
+// intervals: mean ms between two people per direction, 0 for no traffic
+static std::vector<SimPerson> traffic(uint32_t count, uint32_t enteringInterval, uint32_t leavingInterval)
+{
+    std::vector<SimPerson> people;
+    uint32_t seed = 0x2468ACE;
+    auto next = [&seed](uint32_t range) {
+        seed = seed * 1103515245 + 12345;
+        return range ? (seed >> 8) % range : 0;
+    };
+
+    uint32_t entering = 0;
+    uint32_t leaving = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (enteringInterval)
+        {
+            people.push_back({entering, 0, SimPerson::WAIT_FIRST, 0});
+            entering += enteringInterval / 2 + next(enteringInterval);
+        }
+        if (leavingInterval)
+        {
+            people.push_back({leaving, 1, SimPerson::WAIT_FIRST, 0});
+            leaving += leavingInterval / 2 + next(leavingInterval);
+        }
+    }
+    return people;
+}
+
+static void report(const char *name, const SimResult &result)
+{
+    printf("  %-28s %3u people, %5.1f people/min, transit mean %5u ms, max %6u ms\n", name, result.people,
+           result.perMinute(), result.transitMean(), result.transitMax);
+}
+
+static void compare(const char *name, const std::vector<SimPerson> &people, SimResult &pipelined, SimResult &fixed)
+{
+    char label[40];
+    pipelined = simulate(people, true);
+    fixed = simulate(people, false);
+    snprintf(label, sizeof(label), "%s pipelined", name);
+    report(label, pipelined);
+    snprintf(label, sizeof(label), "%s fixed", name);
+    report(label, fixed);
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_airlock_single_person()
+{
+    SimResult result = simulate({{0, 0, SimPerson::WAIT_FIRST, 0}}, true);
+    TEST_ASSERT_EQUAL(1, result.people);
+    TEST_ASSERT_EQUAL(0, result.violations);
+
+    // the inner door waits for the outer one to close after DOOR_OPEN_HOLD_MIN
+    const uint32_t expected = DOOR_SIM_COMMAND + DOOR_SIM_DRIVE_TIME + DOOR_SIM_CROSS_TIME + DOOR_SIM_VESTIBULE +
+                              DOOR_SIM_DRIVE_TIME + DOOR_SIM_COMMAND + DOOR_SIM_DRIVE_TIME + DOOR_SIM_CROSS_TIME;
+    TEST_ASSERT_LESS_OR_EQUAL(expected + 4 * DOOR_SIM_STEP, result.transitMax);
+}
+
+static void test_airlock_one_direction()
+{
+    SimResult pipelined, fixed;
+    compare("entering / 15 s", traffic(40, 15000, 0), pipelined, fixed);
+
+    TEST_ASSERT_EQUAL(40, pipelined.people);
+    TEST_ASSERT_EQUAL(0, pipelined.violations);
+    TEST_ASSERT_EQUAL(0, fixed.violations);
+    TEST_ASSERT_LESS_OR_EQUAL(fixed.transitSum, pipelined.transitSum);
+}
+
+static void test_airlock_both_directions()
+{
+    SimResult pipelined, fixed;
+    compare("both / 30 s", traffic(30, 30000, 30000), pipelined, fixed);
+
+    TEST_ASSERT_EQUAL(60, pipelined.people);
+    TEST_ASSERT_EQUAL(0, pipelined.violations);
+    TEST_ASSERT_EQUAL(0, fixed.violations);
+    TEST_ASSERT_LESS_OR_EQUAL(fixed.transitSum, pipelined.transitSum);
+}
+
+static void test_airlock_rush()
+{
+    // people arrive faster than the airlock cycles, the throughput is its capacity;
+    // a longer hold lets more people through per cycle here, but everybody waits longer
+    SimResult pipelined, fixed;
+    compare("rush both / 1 s", traffic(30, 1000, 1000), pipelined, fixed);
+
+    TEST_ASSERT_EQUAL(60, pipelined.people);
+    TEST_ASSERT_EQUAL(60, fixed.people);
+    TEST_ASSERT_EQUAL(0, pipelined.violations);
+    TEST_ASSERT_EQUAL(0, fixed.violations);
+    TEST_ASSERT_LESS_OR_EQUAL(fixed.transitSum, pipelined.transitSum);
+    TEST_ASSERT_TRUE(pipelined.perMinute() >= 60.0f);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_airlock_single_person);
+    RUN_TEST(test_airlock_one_direction);
+    RUN_TEST(test_airlock_both_directions);
+    RUN_TEST(test_airlock_rush);
+    return UNITY_END();
+}
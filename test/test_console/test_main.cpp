@@ -0,0 +1,216 @@
+#include <unity.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include "DoorConsole.h"
+
+// Parse/dispatch cost of the dc console commands. The table mirrors the
+// names and argument usage of CONSOLE_COMMANDS in DoorControllerModule.cpp,
+// the handlers only count. DoorLookup is compared with the dispatch it
+// replaced: a linear scan over the names with std::string substr compares.
+// Allocations are counted through the global operator new.
+
+static size_t allocations = 0;
+
+void *operator new(size_t size)
+{
+    allocations++;
+    if (void *memory = malloc(size))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept { free(memory); }
+void operator delete(void *memory, size_t) noexcept { free(memory); }
+
+#define DOOR_BENCH_ROUNDS 200000
+
+class BenchConsole
+{
+  public:
+    bool cmd(std::string_view args, bool diagnoseKo)
+    {
+        calls++;
+        argsLength += args.size();
+        return true;
+    }
+
+    uint32_t calls = 0;
+    size_t argsLength = 0;
+};
+
+static constexpr DoorConsoleCommand<BenchConsole> BENCH_COMMANDS[] = {
+    {"dc send", "<it1/it2/it3/opg/opn/clg/cls/name/hex>", "Send built-in command, defined sequence or raw payload to door.", &BenchConsole::cmd},
+    {"dc def", "<name> [<hex> ...]", "Define sequence.", &BenchConsole::cmd},
+    {"dc seq", nullptr, "Print defined sequences.", &BenchConsole::cmd},
+    {"dc script", "<path>", "Run door script from LittleFS.", &BenchConsole::cmd},
+    {"dc script stop", nullptr, "Stop running door script.", &BenchConsole::cmd},
+    {"dc commands", nullptr, "Print door command table.", &BenchConsole::cmd},
+    {"dc commands load", nullptr, "Load door command table.", &BenchConsole::cmd},
+    {"dc commands reset", nullptr, "Use built-in door commands.", &BenchConsole::cmd},
+    {"dc relay", nullptr, "Print contact interface status.", &BenchConsole::cmd},
+    {"dc sensors", nullptr, "Print sensor inputs and their routing.", &BenchConsole::cmd},
+    {"dc sensortest", nullptr, "Print sensor test status and response times.", &BenchConsole::cmd},
+    {"dc sensortest run", nullptr, "Test the safety sensors now.", &BenchConsole::cmd},
+    {"dc sensortest reset", nullptr, "Reset sensor response time statistics.", &BenchConsole::cmd},
+    {"dc status", nullptr, "Print door serial status and link statistics.", &BenchConsole::cmd},
+    {"dc status reset", nullptr, "Reset door link statistics.", &BenchConsole::cmd},
+    {"dc debug", "[0/1/2]", "Disable, enable extensive or enable deferred (binary) debug output.", &BenchConsole::cmd},
+    {"dc counters", nullptr, "Print door cycle and wear counters.", &BenchConsole::cmd},
+    {"dc counters commit", nullptr, "Write door counters to flash now.", &BenchConsole::cmd},
+    {"dc timing", nullptr, "Print learned drive timing.", &BenchConsole::cmd},
+    {"dc timing reset", nullptr, "Forget learned drive timing.", &BenchConsole::cmd},
+    {"dc predictor", nullptr, "Print predictive opening statistics.", &BenchConsole::cmd},
+    {"dc traffic", nullptr, "Print adaptive hold-open statistics.", &BenchConsole::cmd},
+    {"dc direction", nullptr, "Print directional mode statistics.", &BenchConsole::cmd},
+    {"dc fsm", nullptr, "Print door state machine state and last transitions.", &BenchConsole::cmd},
+    {"dc events", nullptr, "Print internal door event subscribers and statistics.", &BenchConsole::cmd},
+    {"dc history", nullptr, "Print door history status.", &BenchConsole::cmd},
+    {"dc history flush", nullptr, "Write buffered door history to flash.", &BenchConsole::cmd},
+    {"dc history clear", nullptr, "Delete door history.", &BenchConsole::cmd},
+    {"dc log", nullptr, "Print deferred debug output.", &BenchConsole::cmd},
+    {"dc log clear", nullptr, "Clear deferred debug output.", &BenchConsole::cmd},
+    {"dc latency", nullptr, "Print trigger to drive latency statistics.", &BenchConsole::cmd},
+    {"dc latency reset", nullptr, "Reset trigger to drive latency statistics.", &BenchConsole::cmd},
+    {"dc perf", nullptr, "Print loop stage runtimes (min/avg/max/p99).", &BenchConsole::cmd},
+    {"dc perf reset", nullptr, "Reset loop stage runtime statistics.", &BenchConsole::cmd},
+};
+
+static constexpr DoorLookup BENCH_LOOKUP(BENCH_COMMANDS);
+static_assert(BENCH_LOOKUP.valid(), "Bench console: ambiguous command table");
+
+static const char *const BENCH_LINES[] = {
+    "dc status",
+    "dc status reset",
+    "dc send opn",
+    "dc send 10 02 01 00 00 00 00 00",
+    "dc debug 2",
+    "dc sensortest reset",
+    "dc history flush",
+    "dc perf",
+    "dc commands load",
+    "dc script /door/init.txt",
+};
+
+#define DOOR_BENCH_LINES (sizeof(BENCH_LINES) / sizeof(BENCH_LINES[0]))
+
+// DoorControllerModule::processCommand()
+static bool dispatchLookup(BenchConsole &console, const std::string &cmd)
+{
+    std::string_view line(cmd);
+    if (line.substr(0, 2) != "dc")
+        return false;
+
+    std::string_view args;
+    const DoorConsoleCommand<BenchConsole> *command = BENCH_LOOKUP.findPrefix(line, args);
+    return command != nullptr && (command->args != nullptr || args.empty()) && (console.*command->handler)(args, false);
+}
+
+// the dispatch before DoorLookup: substr compares over all names
+static bool dispatchLinear(BenchConsole &console, const std::string &cmd)
+{
+    if (cmd.substr(0, 2) != "dc")
+        return false;
+
+    const DoorConsoleCommand<BenchConsole> *command = nullptr;
+    size_t length = 0;
+    for (const DoorConsoleCommand<BenchConsole> &entry : BENCH_COMMANDS)
+    {
+        const std::string name = entry.name;
+        if (cmd.substr(0, name.length()) == name && (cmd.length() == name.length() || cmd[name.length()] == ' ') &&
+            name.length() > length)
+        {
+            command = &entry;
+            length = name.length();
+        }
+    }
+    if (command == nullptr)
+        return false;
+
+    const std::string args = cmd.length() > length ? cmd.substr(length + 1) : std::string();
+    return (command->args != nullptr || args.empty()) && (console.*command->handler)(args, false);
+}
+
+struct BenchResult
+{
+    double nsPerLine;
+    size_t allocations;
+    uint32_t calls;
+};
+
+template <typename Dispatch>
+static BenchResult bench(Dispatch dispatch)
+{
+    std::string lines[DOOR_BENCH_LINES];
+    for (size_t i = 0; i < DOOR_BENCH_LINES; i++)
+        lines[i] = BENCH_LINES[i];
+
+    BenchConsole console;
+    const size_t allocationsBefore = allocations;
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t round = 0; round < DOOR_BENCH_ROUNDS; round++)
+    {
+        for (const std::string &line : lines)
+            dispatch(console, line);
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    const double count = (double)DOOR_BENCH_ROUNDS * DOOR_BENCH_LINES;
+    return {std::chrono::duration<double, std::nano>(end - start).count() / count,
+            allocations - allocationsBefore, console.calls};
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_dispatch_matches()
+{
+    for (const char *text : BENCH_LINES)
+    {
+        const std::string line = text;
+        std::string_view args;
+        const DoorConsoleCommand<BenchConsole> *command = BENCH_LOOKUP.findPrefix(line, args);
+        TEST_ASSERT_NOT_NULL(command);
+
+        BenchConsole lookup, linear;
+        TEST_ASSERT_TRUE(dispatchLookup(lookup, line));
+        TEST_ASSERT_TRUE(dispatchLinear(linear, line));
+        TEST_ASSERT_EQUAL(linear.argsLength, lookup.argsLength);
+    }
+
+    // longest match, arguments only where the command takes them
+    std::string_view args;
+    TEST_ASSERT_EQUAL_STRING("dc status reset", BENCH_LOOKUP.findPrefix("dc status reset", args)->name);
+    TEST_ASSERT_EQUAL_STRING("dc status", BENCH_LOOKUP.findPrefix("dc status  ", args)->name);
+    TEST_ASSERT_TRUE(args.empty());
+    TEST_ASSERT_NULL(BENCH_LOOKUP.findPrefix("dc statu", args));
+    TEST_ASSERT_NULL(BENCH_LOOKUP.find("dc"));
+
+    BenchConsole console;
+    TEST_ASSERT_FALSE(dispatchLookup(console, "dc perf now"));
+    TEST_ASSERT_FALSE(dispatchLookup(console, "dcx perf"));
+    TEST_ASSERT_FALSE(dispatchLookup(console, "xx status"));
+}
+
+static void test_dispatch_benchmark()
+{
+    const BenchResult lookup = bench(dispatchLookup);
+    const BenchResult linear = bench(dispatchLinear);
+    const double lines = (double)DOOR_BENCH_ROUNDS * DOOR_BENCH_LINES;
+    printf("  DoorLookup %7.1f ns/line, %5.2f allocations/line\n", lookup.nsPerLine, lookup.allocations / lines);
+    printf("  linear     %7.1f ns/line, %5.2f allocations/line\n", linear.nsPerLine, linear.allocations / lines);
+
+    TEST_ASSERT_EQUAL(DOOR_BENCH_ROUNDS * DOOR_BENCH_LINES, lookup.calls);
+    TEST_ASSERT_EQUAL(lookup.calls, linear.calls);
+    TEST_ASSERT_EQUAL(0, lookup.allocations);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_dispatch_matches);
+    RUN_TEST(test_dispatch_benchmark);
+    return UNITY_END();
+}
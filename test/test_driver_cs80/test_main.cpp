@@ -0,0 +1,92 @@
+#include <unity.h>
+#include "DoorDriverConformance.h"
+#include "DoorDriverCs80.h"
+
+// Conformance of DoorDriverCs80 (see test/common/DoorDriverConformance.h)
+// and the CS 80 framing: DLE STX <payload, DLE doubled> DLE ETX <XOR>.
+
+typedef DoorDriverConformance<DoorDriverCs80> Conformance;
+typedef Conformance::Bytes Bytes;
+
+#define DLE 0x10
+#define STX 0x02
+#define ETX 0x03
+
+void setUp() {}
+void tearDown() {}
+
+static void test_builtin_commands() { Conformance::builtinCommands(); }
+static void test_payloads() { Conformance::payloads(); }
+static void test_back_to_back() { Conformance::backToBack(); }
+static void test_resync() { Conformance::resync(); }
+static void test_corruption() { Conformance::corruption(); }
+static void test_oversize() { Conformance::oversize(); }
+static void test_states() { Conformance::states(); }
+
+static void test_benchmark()
+{
+    const Conformance::BenchResult result = Conformance::benchmark();
+    Conformance::report(DoorDriverCs80::NAME, result);
+    TEST_ASSERT_EQUAL(DOOR_CONFORMANCE_BENCH_ROUNDS, result.received);
+}
+
+static void test_frame()
+{
+    const Bytes expected = {DLE, STX, 0x00, 0x00, 0x00, 0x52, 0x0B, 0x00, 0x10, 0x10, 0x04, DLE, ETX, 0x5D};
+    TEST_ASSERT_TRUE(Conformance::encode(PAYLOAD_OPEN, DoorDriverCs80::PAYLOAD_SIZE) == expected);
+    TEST_ASSERT_EQUAL(DoorDriverCs80::PAYLOAD_SIZE * 2 + 5, DoorDriverCs80::frameSize(DoorDriverCs80::PAYLOAD_SIZE));
+
+    // every byte stuffed, the stuffed pairs cancel out in the checksum
+    const uint8_t dles[DoorDriverCs80::PAYLOAD_SIZE] = {DLE, DLE, DLE, DLE, DLE, DLE, DLE, DLE};
+    const Bytes frame = Conformance::encode(dles, sizeof(dles));
+    TEST_ASSERT_EQUAL(DoorDriverCs80::frameSize(sizeof(dles)), frame.size());
+    TEST_ASSERT_EQUAL_HEX8(0x00, frame.back());
+}
+
+static void test_receive_errors()
+{
+    DoorDriverCs80 driver;
+    Bytes frame = Conformance::encode(PAYLOAD_CLOSED, DoorDriverCs80::PAYLOAD_SIZE);
+
+    frame.back() ^= 0x01;
+    std::vector<DoorDriverRx> results = Conformance::receive(driver, frame);
+    TEST_ASSERT_TRUE(results.size() == 1 && results[0] == DoorDriverRx::CHECKSUM_ERROR);
+
+    // DLE followed by anything but DLE or ETX
+    const Bytes framing = {DLE, STX, 0x00, DLE, 0x05, 0x00};
+    results = Conformance::receive(driver, framing);
+    TEST_ASSERT_TRUE(results.size() == 1 && results[0] == DoorDriverRx::FRAMING_ERROR);
+
+    // DLE DLE before STX is a stuffed DLE in noise, the frame starts at the next STX
+    Bytes noise = {DLE, DLE};
+    const Bytes open = Conformance::encode(PAYLOAD_OPEN, DoorDriverCs80::PAYLOAD_SIZE);
+    noise.insert(noise.end(), open.begin() + 1, open.end());
+    Bytes received;
+    results = Conformance::receive(driver, noise, &received);
+    TEST_ASSERT_TRUE(results.size() == 1 && results[0] == DoorDriverRx::FRAME);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(PAYLOAD_OPEN, received.data(), DoorDriverCs80::PAYLOAD_SIZE);
+}
+
+static void test_raw_state()
+{
+    TEST_ASSERT_EQUAL_HEX8(DOOR_STATE_OPEN, DoorDriverCs80::rawState(PAYLOAD_OPEN));
+    TEST_ASSERT_TRUE(DoorDriverCs80::decodeState(PAYLOAD_INIT1) == DoorDriverState::UNKNOWN);
+    TEST_ASSERT_TRUE(DoorDriverCs80::decodeState(PAYLOAD_OPENING_PRE1) == DoorDriverState::CLOSED);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_builtin_commands);
+    RUN_TEST(test_payloads);
+    RUN_TEST(test_back_to_back);
+    RUN_TEST(test_resync);
+    RUN_TEST(test_corruption);
+    RUN_TEST(test_oversize);
+    RUN_TEST(test_states);
+    RUN_TEST(test_frame);
+    RUN_TEST(test_receive_errors);
+    RUN_TEST(test_raw_state);
+    RUN_TEST(test_benchmark);
+    return UNITY_END();
+}
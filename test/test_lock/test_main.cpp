@@ -0,0 +1,251 @@
+#include <unity.h>
+#include "DoorLock.h"
+
+// Lock requests arriving in every state of the channel state machine. The
+// door is a small model of a leaf: ACTION_CLOSE makes a closable leaf close
+// (TRANSITION, then CLOSED after DOOR_CLOSE_TIME), ACTION_ENGAGE and
+// ACTION_RELEASE move it between CLOSED and CLOSED_LOCKED. A leaf that is not
+// closable stands for a blocked sensor, a mode without state machine or a
+// lost MLD: the request raises FSM_EVENT_LOCK, which is dropped.
+
+#define DOOR_CLOSE_TIME 3000
+#define DOOR_LOOP_INTERVAL 10
+
+enum DoorModelState : uint8_t
+{
+    STATE_UNDEFINED,
+    STATE_TRANSITION,
+    STATE_OPEN,
+    STATE_CLOSED,
+    STATE_CLOSED_LOCKED
+};
+
+struct DoorModel
+{
+    DoorModelState state = STATE_UNDEFINED;
+    bool closable = true;
+    uint32_t closedAt = 0;
+    uint8_t closeRequests = 0;
+    uint8_t statusReports = 0;
+
+    bool closed() const { return state == STATE_CLOSED || state == STATE_CLOSED_LOCKED; }
+
+    void apply(uint8_t actions, uint32_t now)
+    {
+        if (actions & DoorLock::ACTION_RELEASE)
+            state = closed() ? STATE_CLOSED : state;
+        if (actions & DoorLock::ACTION_ENGAGE)
+            state = STATE_CLOSED_LOCKED;
+        if (actions & DoorLock::ACTION_CLOSE)
+        {
+            closeRequests++;
+            if (closable && !closed() && state != STATE_TRANSITION)
+            {
+                state = STATE_TRANSITION;
+                closedAt = now + DOOR_CLOSE_TIME;
+            }
+        }
+        if (actions & DoorLock::ACTION_STATUS)
+            statusReports++;
+    }
+
+    void loop(uint32_t now)
+    {
+        if (state == STATE_TRANSITION && (int32_t)(now - closedAt) >= 0)
+            state = STATE_CLOSED;
+    }
+};
+
+static DoorLock doorLock;
+static DoorModel door;
+static uint32_t now;
+
+// runs the loop for duration ms, returns all actions requested meanwhile
+static uint8_t run(uint32_t duration)
+{
+    uint8_t actions = DoorLock::ACTION_NONE;
+    for (uint32_t end = now + duration; now != end; now += DOOR_LOOP_INTERVAL)
+    {
+        door.loop(now);
+        const uint8_t loopActions = doorLock.loop(door.closed(), now);
+        door.apply(loopActions, now);
+        actions |= loopActions;
+    }
+    return actions;
+}
+
+static uint8_t request(bool active)
+{
+    const uint8_t actions = doorLock.request(active, now);
+    door.apply(actions, now);
+    now += DOOR_LOOP_INTERVAL;
+    return actions;
+}
+
+void setUp()
+{
+    doorLock = DoorLock();
+    door = DoorModel();
+    now = 1000;
+}
+
+void tearDown() {}
+
+static void assertLocked()
+{
+    TEST_ASSERT_EQUAL(DoorLock::LOCK_IDLE, doorLock.step());
+    TEST_ASSERT_TRUE(doorLock.engaged());
+    TEST_ASSERT_TRUE(doorLock.locked());
+    TEST_ASSERT_EQUAL(STATE_CLOSED_LOCKED, door.state);
+}
+
+static void test_request_in_closed()
+{
+    door.state = STATE_CLOSED;
+    TEST_ASSERT_EQUAL(DoorLock::ACTION_CLOSE, request(true));
+    TEST_ASSERT_EQUAL(DoorLock::ACTION_ENGAGE, run(DOOR_LOOP_INTERVAL));
+    TEST_ASSERT_EQUAL(DoorLock::LOCK_ENGAGING, doorLock.step());
+    TEST_ASSERT_FALSE(doorLock.locked());
+
+    TEST_ASSERT_EQUAL(DoorLock::ACTION_STATUS, run(LOCK_VERIFY_TIME + DOOR_LOOP_INTERVAL));
+    assertLocked();
+    TEST_ASSERT_EQUAL(0, doorLock.attempts());
+}
+
+static void test_request_in_open()
+{
+    door.state = STATE_OPEN;
+    request(true);
+    TEST_ASSERT_EQUAL(STATE_TRANSITION, door.state);
+    TEST_ASSERT_EQUAL(DoorLock::ACTION_NONE, run(DOOR_CLOSE_TIME - DOOR_LOOP_INTERVAL));
+    TEST_ASSERT_EQUAL(DoorLock::LOCK_CLOSING, doorLock.step());
+
+    run(DOOR_LOOP_INTERVAL * 2 + LOCK_VERIFY_TIME);
+    assertLocked();
+    TEST_ASSERT_EQUAL(1, door.closeRequests);
+    TEST_ASSERT_EQUAL(1, door.statusReports);
+}
+
+static void test_request_in_transition()
+{
+    // a closing leaf that is already half way
+    door.state = STATE_TRANSITION;
+    door.closedAt = now + DOOR_CLOSE_TIME / 2;
+    request(true);
+    TEST_ASSERT_EQUAL(STATE_TRANSITION, door.state);
+
+    run(DOOR_CLOSE_TIME / 2 + DOOR_LOOP_INTERVAL + LOCK_VERIFY_TIME + DOOR_LOOP_INTERVAL);
+    assertLocked();
+}
+
+static void test_request_in_undefined()
+{
+    // no state from the drive (lost MLD), the leaf never reports CLOSED
+    door.state = STATE_UNDEFINED;
+    door.closable = false;
+    TEST_ASSERT_EQUAL(DoorLock::ACTION_CLOSE, request(true));
+
+    // each timeout asks again and counts as an attempt
+    for (uint8_t attempt = 1; attempt < LOCK_ATTEMPTS; attempt++)
+    {
+        TEST_ASSERT_EQUAL(DoorLock::ACTION_NONE, run(LOCK_REQUEST_MLD_TIMEOUT - DOOR_LOOP_INTERVAL));
+        TEST_ASSERT_EQUAL(DoorLock::ACTION_CLOSE, run(DOOR_LOOP_INTERVAL));
+        TEST_ASSERT_EQUAL(attempt, doorLock.attempts());
+    }
+
+    // the last one gives up and reports the status
+    TEST_ASSERT_EQUAL(DoorLock::ACTION_NONE, run(LOCK_REQUEST_MLD_TIMEOUT - DOOR_LOOP_INTERVAL));
+    TEST_ASSERT_EQUAL(DoorLock::ACTION_STATUS, run(DOOR_LOOP_INTERVAL));
+    TEST_ASSERT_EQUAL(DoorLock::LOCK_FAILED, doorLock.step());
+    TEST_ASSERT_FALSE(doorLock.locked());
+    TEST_ASSERT_FALSE(doorLock.engaged());
+    TEST_ASSERT_EQUAL(LOCK_ATTEMPTS, door.closeRequests);
+
+    // and stays quiet until the next request
+    TEST_ASSERT_EQUAL(DoorLock::ACTION_NONE, run(LOCK_REQUEST_MLD_TIMEOUT * 3));
+    TEST_ASSERT_EQUAL(1, door.statusReports);
+
+    // which starts over, the door is back
+    door.state = STATE_OPEN;
+    door.closable = true;
+    TEST_ASSERT_EQUAL(DoorLock::ACTION_CLOSE, request(true));
+    TEST_ASSERT_EQUAL(0, doorLock.attempts());
+    run(DOOR_CLOSE_TIME + DOOR_LOOP_INTERVAL + LOCK_VERIFY_TIME + DOOR_LOOP_INTERVAL);
+    assertLocked();
+}
+
+static void test_request_in_closed_locked()
+{
+    door.state = STATE_CLOSED;
+    request(true);
+    run(DOOR_LOOP_INTERVAL + LOCK_VERIFY_TIME + DOOR_LOOP_INTERVAL);
+    assertLocked();
+
+    // repeated lock request, nothing to do
+    TEST_ASSERT_EQUAL(DoorLock::ACTION_NONE, request(true));
+    TEST_ASSERT_EQUAL(DoorLock::ACTION_NONE, run(LOCK_REQUEST_MLD_TIMEOUT));
+    assertLocked();
+
+    // unlocking releases at once
+    TEST_ASSERT_EQUAL(DoorLock::ACTION_RELEASE | DoorLock::ACTION_STATUS, request(false));
+    TEST_ASSERT_EQUAL(STATE_CLOSED, door.state);
+    TEST_ASSERT_FALSE(doorLock.engaged());
+    TEST_ASSERT_FALSE(doorLock.locked());
+    TEST_ASSERT_FALSE(doorLock.requested());
+}
+
+static void test_unlock_while_closing()
+{
+    door.state = STATE_OPEN;
+    door.closable = false;
+    request(true);
+    run(LOCK_REQUEST_MLD_TIMEOUT / 2);
+
+    // nothing engaged yet, only the status is reported
+    TEST_ASSERT_EQUAL(DoorLock::ACTION_STATUS, request(false));
+    TEST_ASSERT_EQUAL(DoorLock::LOCK_IDLE, doorLock.step());
+    TEST_ASSERT_EQUAL(DoorLock::ACTION_NONE, run(LOCK_REQUEST_MLD_TIMEOUT * 2));
+}
+
+static void test_door_moves_while_engaging()
+{
+    door.state = STATE_CLOSED;
+    request(true);
+    for (uint8_t attempt = 1; attempt <= LOCK_ATTEMPTS; attempt++)
+    {
+        // the first attempt finds the leaf closed, the others close it again
+        TEST_ASSERT_EQUAL(DoorLock::ACTION_ENGAGE,
+                          run(attempt == 1 ? DOOR_LOOP_INTERVAL : DOOR_CLOSE_TIME + DOOR_LOOP_INTERVAL));
+
+        // the bolt misses, the leaf is pushed open
+        door.state = STATE_OPEN;
+        const uint8_t actions = run(DOOR_LOOP_INTERVAL);
+        TEST_ASSERT_TRUE(actions & DoorLock::ACTION_RELEASE);
+        TEST_ASSERT_FALSE(doorLock.engaged());
+        TEST_ASSERT_EQUAL(attempt, doorLock.attempts());
+        if (attempt == LOCK_ATTEMPTS)
+        {
+            TEST_ASSERT_EQUAL(DoorLock::ACTION_RELEASE | DoorLock::ACTION_STATUS, actions);
+            break;
+        }
+
+        TEST_ASSERT_EQUAL(DoorLock::ACTION_RELEASE | DoorLock::ACTION_CLOSE, actions);
+        TEST_ASSERT_EQUAL(STATE_TRANSITION, door.state);
+    }
+
+    TEST_ASSERT_EQUAL(DoorLock::LOCK_FAILED, doorLock.step());
+    TEST_ASSERT_FALSE(doorLock.locked());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_request_in_undefined);
+    RUN_TEST(test_request_in_transition);
+    RUN_TEST(test_request_in_open);
+    RUN_TEST(test_request_in_closed);
+    RUN_TEST(test_request_in_closed_locked);
+    RUN_TEST(test_unlock_while_closing);
+    RUN_TEST(test_door_moves_while_engaging);
+    return UNITY_END();
+}
@@ -0,0 +1,241 @@
+#include <unity.h>
+#include <cstdio>
+#include <vector>
+#include "DoorPredictor.h"
+
+// Scores predictive opening against the plain policy on a radar trace of a
+// shop entrance at a sidewalk: the outside radar mostly sees people passing
+// by (short pulses, nobody crosses), people entering and leaving reach the
+// door DOOR_SIM_APPROACH after their radar edge and cross it once it is open
+// (AIR sensor active for DOOR_SIM_CROSS_TIME).
+//
+// plain:      open on any active radar in CLOSED, a closing door finishes first
+// predictive: open on DoorPredictor::trigger() in CLOSED, reopen a closing
+//             door if preOpenAllowed(), learn from the AIR sensor
+//
+// latency is the time a person waits at the door until it is fully open,
+// a false opening is a cycle without anybody crossing.
+
+#define DOOR_SIM_STEP 10
+#define DOOR_SIM_DRIVE_TIME 2000 // closed to open and back
+#define DOOR_SIM_HOLD 1000       // DOOR_OPEN_HOLD_MIN
+#define DOOR_SIM_APPROACH 1500   // radar edge to door
+#define DOOR_SIM_CROSS_TIME 800
+#define DOOR_SIM_DURATION 3600000
+
+struct SimPerson
+{
+    uint32_t start;
+    DoorPredictor::Radar radar;
+    uint16_t pulse; // radar active time of a pass-by
+    bool crosses;
+    // state
+    uint32_t crossedAt;
+    bool done;
+};
+
+struct SimResult
+{
+    uint32_t openings;
+    uint32_t falseOpenings;
+    uint32_t crossings;
+    uint64_t waitSum; // ms
+    uint32_t waitMax; // ms
+};
+
+// deterministic stand-in for a recorded trace, an hour of traffic
+static std::vector<SimPerson> recordedTrace()
+{
+    std::vector<SimPerson> trace;
+    uint32_t seed = 0x1234567;
+    auto next = [&seed](uint32_t range) {
+        seed = seed * 1103515245 + 12345;
+        return (seed >> 8) % range;
+    };
+
+    for (uint32_t t = next(4000); t < DOOR_SIM_DURATION; t += 1000 + next(6000))
+        trace.push_back({t, DoorPredictor::RADAR_OUTSIDE, static_cast<uint16_t>(80 + next(200)), false, 0, false});
+    for (uint32_t t = next(10000); t < DOOR_SIM_DURATION; t += 5000 + next(30000))
+        trace.push_back({t, DoorPredictor::RADAR_OUTSIDE, 0, true, 0, false});
+    for (uint32_t t = next(10000); t < DOOR_SIM_DURATION; t += 5000 + next(30000))
+        trace.push_back({t, DoorPredictor::RADAR_INSIDE, 0, true, 0, false});
+    return trace;
+}
+
+static SimResult simulate(bool predictive)
+{
+    enum
+    {
+        CLOSED,
+        OPENING,
+        OPEN,
+        CLOSING
+    } door = CLOSED;
+    uint32_t position = 0; // ms of drive time, 0 closed
+    uint32_t lastActivity = 0;
+    bool cycleAir = false;
+    bool radar[DoorPredictor::RADAR_COUNT] = {};
+
+    DoorPredictor predictor;
+    std::vector<SimPerson> trace = recordedTrace();
+    SimResult result = {};
+
+    for (uint32_t now = 0; now < DOOR_SIM_DURATION + 60000; now += DOOR_SIM_STEP)
+    {
+        // sensors
+        bool active[DoorPredictor::RADAR_COUNT] = {};
+        bool air = false;
+        for (SimPerson &person : trace)
+        {
+            if (person.done || now < person.start)
+                continue;
+
+            if (!person.crosses)
+            {
+                person.done = now >= person.start + person.pulse;
+                active[person.radar] = active[person.radar] || !person.done;
+                continue;
+            }
+
+            const uint32_t arrival = person.start + DOOR_SIM_APPROACH;
+            if (now >= arrival && door == OPEN && person.crossedAt == 0)
+            {
+                const uint32_t wait = now - arrival;
+                person.crossedAt = now;
+                result.crossings++;
+                result.waitSum += wait;
+                result.waitMax = wait > result.waitMax ? wait : result.waitMax;
+            }
+
+            person.done = person.crossedAt != 0 && now >= person.crossedAt + DOOR_SIM_CROSS_TIME;
+            active[person.radar] = active[person.radar] || !person.done;
+            air = air || (person.crossedAt != 0 && !person.done);
+        }
+
+        for (uint8_t i = 0; i < DoorPredictor::RADAR_COUNT; i++)
+        {
+            if (radar[i] == active[i])
+                continue;
+            radar[i] = active[i];
+            predictor.radarChanged(static_cast<DoorPredictor::Radar>(i), radar[i], now);
+        }
+
+        if (air)
+        {
+            cycleAir = true;
+            predictor.airActive();
+        }
+
+        // controller
+        const bool anyRadar = radar[DoorPredictor::RADAR_INSIDE] || radar[DoorPredictor::RADAR_OUTSIDE];
+        const DoorPredictor::Radar trigger = predictor.trigger(now);
+        const bool open = predictive ? trigger != DoorPredictor::RADAR_COUNT : anyRadar;
+        if ((door == CLOSED && open) || (door == CLOSING && predictive && predictor.preOpenAllowed(trigger)))
+        {
+            if (door == CLOSED)
+            {
+                result.openings++;
+                cycleAir = false;
+            }
+            door = OPENING;
+            predictor.cycleOpened(predictive ? trigger : DoorPredictor::RADAR_COUNT);
+        }
+
+        if (anyRadar || air)
+            lastActivity = now;
+
+        // drive
+        switch (door)
+        {
+            case OPENING:
+                position += DOOR_SIM_STEP;
+                door = position >= DOOR_SIM_DRIVE_TIME ? OPEN : OPENING;
+                break;
+            case OPEN:
+                door = now - lastActivity >= DOOR_SIM_HOLD ? CLOSING : OPEN;
+                break;
+            case CLOSING:
+                position -= DOOR_SIM_STEP;
+                if (position > 0)
+                    break;
+                door = CLOSED;
+                result.falseOpenings += cycleAir ? 0 : 1;
+                predictor.cycleClosed();
+                break;
+            case CLOSED:
+                break;
+        }
+    }
+
+    return result;
+}
+
+static void report(const char *name, const SimResult &result)
+{
+    printf("  %-10s openings %4u, false %4u (%3u%%), crossings %3u, wait mean %4llu ms, max %4u ms\n", name,
+           result.openings, result.falseOpenings, result.falseOpenings * 100 / result.openings, result.crossings,
+           (unsigned long long)(result.waitSum / result.crossings), result.waitMax);
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_predictor_trace()
+{
+    const SimResult plain = simulate(false);
+    const SimResult predictive = simulate(true);
+    report("plain", plain);
+    report("predictive", predictive);
+
+    // everybody gets through with both policies
+    TEST_ASSERT_EQUAL(plain.crossings, predictive.crossings);
+    TEST_ASSERT_GREATER_THAN(0, predictive.crossings);
+
+    // learning the pass-by radar at least halves the useless cycles
+    TEST_ASSERT_LESS_OR_EQUAL(plain.falseOpenings / 2, predictive.falseOpenings);
+
+    // the confirm delay costs the people entering less than reopening a closing door saves
+    TEST_ASSERT_LESS_OR_EQUAL(plain.waitSum, predictive.waitSum);
+}
+
+static void test_predictor_learns_pass_by()
+{
+    DoorPredictor predictor;
+    uint32_t now = 0;
+
+    // radars start trusted, a pulse opens at once
+    predictor.radarChanged(DoorPredictor::RADAR_OUTSIDE, true, now);
+    TEST_ASSERT_EQUAL(DoorPredictor::RADAR_OUTSIDE, predictor.trigger(now));
+    TEST_ASSERT_TRUE(predictor.preOpenAllowed(DoorPredictor::RADAR_OUTSIDE));
+
+    // openings without AIR make it a pass-by radar
+    for (uint8_t i = 0; i < 16; i++)
+    {
+        predictor.cycleOpened(DoorPredictor::RADAR_OUTSIDE);
+        predictor.cycleClosed();
+    }
+    TEST_ASSERT_FALSE(predictor.preOpenAllowed(DoorPredictor::RADAR_OUTSIDE));
+    TEST_ASSERT_TRUE(predictor.preOpenAllowed(DoorPredictor::RADAR_INSIDE));
+
+    now = 10000;
+    predictor.radarChanged(DoorPredictor::RADAR_OUTSIDE, true, now);
+    TEST_ASSERT_EQUAL(DoorPredictor::RADAR_COUNT, predictor.trigger(now + DOOR_PREDICTOR_CONFIRM_DELAY - 1));
+    TEST_ASSERT_EQUAL(DoorPredictor::RADAR_OUTSIDE, predictor.trigger(now + DOOR_PREDICTOR_CONFIRM_DELAY));
+
+    // and crossings make it trusted again
+    for (uint8_t i = 0; i < 16; i++)
+    {
+        predictor.cycleOpened(DoorPredictor::RADAR_OUTSIDE);
+        predictor.airActive();
+        predictor.cycleClosed();
+    }
+    TEST_ASSERT_TRUE(predictor.preOpenAllowed(DoorPredictor::RADAR_OUTSIDE));
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_predictor_learns_pass_by);
+    RUN_TEST(test_predictor_trace);
+    return UNITY_END();
+}
@@ -0,0 +1,234 @@
+#include <unity.h>
+#include <cstdio>
+#include <vector>
+#include "DoorTraffic.h"
+
+// Simulation harness for the adaptive hold-open time: one door in automatic
+// mode with a drive model, people trigger the radar, reach the door
+// DOOR_SIM_APPROACH later and cross it once it is fully open. Each traffic
+// profile runs with the fixed hold (DOOR_OPEN_MIN after OPEN) and with
+// DoorTraffic, wired like DoorChannel (opened() on OPEN, closed() on the
+// close command, holdTime() after lastTrigger()).
+//
+// Reported are the cycles saved and the price in extra open time (heat
+// loss), from the simulation and from the counters of DoorTraffic ("dc
+// traffic"), which have to agree. DoorTraffic is fed the drive times and the
+// sensors holding the door like DoorChannel and the module do.
+
+#define DOOR_SIM_STEP 10
+#define DOOR_SIM_DRIVE_TIME 2000
+#define DOOR_SIM_APPROACH 1500
+#define DOOR_SIM_CROSS_TIME 800
+#define DOOR_SIM_HOLD_MAX 10000 // ParamDOR_AdaptiveHoldMax default
+#define DOOR_SIM_DURATION 1800000
+#define DOOR_SIM_CYCLES_TOLERANCE 10 // %
+#define DOOR_SIM_OPEN_TOLERANCE 2    // %
+
+struct SimResult
+{
+    uint32_t cycles;
+    uint32_t openTime; // ms out of the closed position
+    uint32_t people;
+    uint64_t waitSum; // ms at the door
+    uint32_t savedCycles;  // DoorTraffic
+    uint32_t lostCycles;   // DoorTraffic
+    int32_t extendedOpen;  // DoorTraffic, ms
+};
+
+// arrivals with a mean interval, deterministic
+static std::vector<uint32_t> arrivals(uint32_t interval)
+{
+    std::vector<uint32_t> times;
+    uint32_t seed = 0x13579BD;
+    for (uint32_t t = 1000; t < DOOR_SIM_DURATION; )
+    {
+        times.push_back(t);
+        seed = seed * 1103515245 + 12345;
+        t += interval / 4 + (seed >> 8) % (interval * 3 / 2);
+    }
+    return times;
+}
+
+static SimResult simulate(const std::vector<uint32_t> &people, bool adaptive)
+{
+    enum
+    {
+        CLOSED,
+        OPENING,
+        OPEN,
+        CLOSING
+    } door = CLOSED;
+    uint32_t position = 0;
+    uint32_t openSince = 0;
+    bool radar = false;
+    std::vector<uint32_t> crossedAt(people.size(), 0);
+
+    DoorTraffic traffic;
+    SimResult result = {};
+
+    for (uint32_t now = 0; now < DOOR_SIM_DURATION + 60000; now += DOOR_SIM_STEP)
+    {
+        // a person keeps the radar active from the trigger until crossed, AIR while crossing
+        bool active = false;
+        bool air = false;
+        for (size_t i = 0; i < people.size() && people[i] <= now; i++)
+        {
+            if (crossedAt[i] == 0 && now >= people[i] + DOOR_SIM_APPROACH && door == OPEN)
+            {
+                crossedAt[i] = now;
+                result.people++;
+                result.waitSum += now - people[i] - DOOR_SIM_APPROACH;
+            }
+            const bool crossing = crossedAt[i] != 0 && now < crossedAt[i] + DOOR_SIM_CROSS_TIME;
+            active = active || crossedAt[i] == 0 || crossing;
+            air = air || crossing;
+        }
+
+        if (active && !radar)
+            traffic.trigger(now);
+        radar = active;
+        traffic.held(radar || air, now);
+
+        result.openTime += position > 0 ? DOOR_SIM_STEP : 0;
+        switch (door)
+        {
+            case CLOSED:
+                if (!radar)
+                    break;
+                door = OPENING;
+                result.cycles++;
+                break;
+            case OPENING:
+                position += DOOR_SIM_STEP;
+                if (position < DOOR_SIM_DRIVE_TIME)
+                    break;
+                door = OPEN;
+                openSince = now;
+                traffic.opened(now, DOOR_OPEN_MIN, DOOR_SIM_DRIVE_TIME, DOOR_SIM_DRIVE_TIME);
+                break;
+            case OPEN:
+            {
+                // DoorChannel::doorHoldSince() and doorOpenMin()
+                uint32_t holdSince = openSince;
+                uint32_t hold = DOOR_OPEN_MIN;
+                if (adaptive)
+                {
+                    if ((int32_t)(traffic.lastTrigger() - openSince) > 0)
+                        holdSince = traffic.lastTrigger();
+                    hold = traffic.holdTime(DOOR_OPEN_MIN, DOOR_SIM_HOLD_MAX);
+                }
+
+                if (radar || air || now - holdSince < hold)
+                    break;
+                door = CLOSING;
+                traffic.closed(now);
+                break;
+            }
+            case CLOSING:
+                position -= DOOR_SIM_STEP;
+                if (position == 0)
+                    door = CLOSED;
+                break;
+        }
+    }
+
+    result.savedCycles = traffic.savedCycles();
+    result.lostCycles = traffic.lostCycles();
+    result.extendedOpen = traffic.extendedOpen();
+    return result;
+}
+
+// the counters of DoorTraffic against the simulation: cycles saved within
+// DOOR_SIM_CYCLES_TOLERANCE, open time within DOOR_SIM_OPEN_TOLERANCE of the fixed open time
+static void compare(const char *name, uint32_t interval, SimResult &fixed, SimResult &adaptive)
+{
+    const std::vector<uint32_t> people = arrivals(interval);
+    fixed = simulate(people, false);
+    adaptive = simulate(people, true);
+
+    const int32_t saved = (int32_t)fixed.cycles - (int32_t)adaptive.cycles;
+    const int32_t energy = (int32_t)adaptive.openTime - (int32_t)fixed.openTime;
+    printf("  %-8s %4u people, cycles %4u -> %4u (saved %4d, counted %4d), open time %+6.1f s (counted %6.1f s), "
+           "wait %4llu -> %4llu ms\n",
+           name, adaptive.people, fixed.cycles, adaptive.cycles, saved, (int32_t)(adaptive.savedCycles - adaptive.lostCycles), energy / 1000.0,
+           adaptive.extendedOpen / 1000.0, (unsigned long long)(fixed.waitSum / fixed.people),
+           (unsigned long long)(adaptive.waitSum / adaptive.people));
+
+    TEST_ASSERT_INT_WITHIN(saved * DOOR_SIM_CYCLES_TOLERANCE / 100 + 2, saved,
+                           (int32_t)(adaptive.savedCycles - adaptive.lostCycles));
+    TEST_ASSERT_INT_WITHIN(fixed.openTime * DOOR_SIM_OPEN_TOLERANCE / 100, energy, adaptive.extendedOpen);
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_hold_time()
+{
+    DoorTraffic traffic;
+    uint32_t now = 0;
+
+    // no traffic yet, the mean interval is DOOR_TRAFFIC_INTERVAL_MAX: sparse, shortest hold
+    TEST_ASSERT_EQUAL(DOOR_OPEN_HOLD_MIN, traffic.holdTime(DOOR_OPEN_MIN, DOOR_SIM_HOLD_MAX));
+
+    // a trigger every 2 s holds for 1.5 mean intervals
+    for (uint8_t i = 0; i < 100; i++)
+        traffic.trigger(now += 2000);
+    TEST_ASSERT_EQUAL(3000, traffic.holdTime(DOOR_OPEN_HOLD_MIN, DOOR_SIM_HOLD_MAX));
+    TEST_ASSERT_EQUAL(DOOR_OPEN_MIN + 1000, traffic.holdTime(DOOR_OPEN_MIN + 1000, DOOR_SIM_HOLD_MAX));
+
+    // every 5 s, 7.5 s hold, above the maximum it falls back to the short hold
+    for (uint8_t i = 0; i < 100; i++)
+        traffic.trigger(now += 5000);
+    TEST_ASSERT_EQUAL(7500, traffic.holdTime(DOOR_OPEN_MIN, DOOR_SIM_HOLD_MAX));
+    TEST_ASSERT_EQUAL(DOOR_OPEN_HOLD_MIN, traffic.holdTime(DOOR_OPEN_MIN, 7000));
+
+    // silence does not change the hold, it enters the mean with the next trigger
+    now += 120000;
+    TEST_ASSERT_EQUAL(7500, traffic.holdTime(DOOR_OPEN_MIN, DOOR_SIM_HOLD_MAX));
+    traffic.trigger(now);
+    TEST_ASSERT_EQUAL(DOOR_OPEN_HOLD_MIN, traffic.holdTime(DOOR_OPEN_MIN, DOOR_SIM_HOLD_MAX));
+}
+
+static void test_sparse_traffic()
+{
+    SimResult fixed, adaptive;
+    compare("sparse", 60000, fixed, adaptive);
+
+    // nobody to wait for, the door closes earlier than with the fixed hold
+    TEST_ASSERT_EQUAL(fixed.people, adaptive.people);
+    TEST_ASSERT_EQUAL(fixed.cycles, adaptive.cycles);
+    TEST_ASSERT_LESS_THAN(fixed.openTime, adaptive.openTime);
+    TEST_ASSERT_EQUAL(0, adaptive.savedCycles);
+}
+
+static void test_moderate_traffic()
+{
+    SimResult fixed, adaptive;
+    compare("moderate", 5000, fixed, adaptive);
+
+    TEST_ASSERT_EQUAL(fixed.people, adaptive.people);
+    TEST_ASSERT_LESS_THAN(fixed.cycles, adaptive.cycles);
+    TEST_ASSERT_LESS_OR_EQUAL(fixed.waitSum, adaptive.waitSum);
+}
+
+static void test_dense_traffic()
+{
+    SimResult fixed, adaptive;
+    compare("dense", 2500, fixed, adaptive);
+
+    // cycles saved, everybody passes without waiting for the door to cycle
+    TEST_ASSERT_EQUAL(fixed.people, adaptive.people);
+    TEST_ASSERT_LESS_THAN(fixed.cycles, adaptive.cycles);
+    TEST_ASSERT_GREATER_THAN(0, adaptive.savedCycles);
+    TEST_ASSERT_LESS_OR_EQUAL(fixed.waitSum, adaptive.waitSum);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_hold_time);
+    RUN_TEST(test_sparse_traffic);
+    RUN_TEST(test_moderate_traffic);
+    RUN_TEST(test_dense_traffic);
+    return UNITY_END();
+}